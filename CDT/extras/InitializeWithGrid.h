@@ -14,9 +14,7 @@
 #include "CDT.h"
 #include "CDTUtils.h"
 
-#ifdef CDT_CXX11_IS_SUPPORTED
 #include <algorithm>
-#endif
 #include <cstddef>
 #include <iterator>
 #include <vector>
@@ -142,8 +140,162 @@ void generateGridTriangles(
     }
 }
 
+/**
+ * Find index of grid tick interval containing a coordinate
+ *
+ * Guesses the interval assuming uniform ticks and corrects the guess by
+ * bisection: O(1) for regular grids, O(log(n)) for irregular grids.
+ * @param c coordinate
+ * @param n number of tick intervals
+ * @param tick functor returning tick coordinate by its index
+ * @return index of interval, clamped to [0, n-1]
+ */
+template <typename T, typename TGetTick>
+std::size_t
+findTickInterval(const T c, const std::size_t n, const TGetTick& tick)
+{
+    const T first = tick(0);
+    const T last = tick(n);
+    if(!(c > first))
+        return 0;
+    if(!(c < last))
+        return n - 1;
+    const std::size_t guess = std::min(
+        static_cast<std::size_t>((c - first) / (last - first) * T(n)), n - 1);
+    // bisect with tick(lo) <= c < tick(hi)
+    std::size_t lo = 0;
+    std::size_t hi = n;
+    if(tick(guess) <= c)
+    {
+        if(c < tick(guess + 1))
+            return guess;
+        lo = guess + 1;
+    }
+    else
+    {
+        if(tick(guess - 1) <= c)
+            return guess - 1;
+        hi = guess - 1;
+    }
+    while(hi - lo > 1)
+    {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if(tick(mid) <= c)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/// Get X-tick of grid from grid vertices
+template <typename T>
+struct GridTickX
+{
+    const std::vector<V2d<T> >& vertices;
+    T operator()(const std::size_t i) const
+    {
+        return vertices[i].x;
+    }
+};
+
+/// Get Y-tick of grid from grid vertices
+template <typename T>
+struct GridTickY
+{
+    const std::vector<V2d<T> >& vertices;
+    std::size_t xres;
+    T operator()(const std::size_t i) const
+    {
+        return vertices[i * (xres + 1)].y;
+    }
+};
+
 } // namespace detail
 
+/**
+ * Locator for triangulations initialized with grid super-geometry
+ *
+ * Grid vertices are not stored: near grid vertex is computed from the grid
+ * ticks in O(1) for regular grids (O(log(resolution)) for irregular grids).
+ * Only the points inserted after the grid are added to a fallback locator.
+ * Nearest of the grid vertex and the fallback's point is returned, so the
+ * walk is short also after the grid was refined by inserted points.
+ *
+ * Should be used with @ref initializeWithRegularGrid or
+ * @ref initializeWithIrregularGrid with the same resolution, e.g.:
+ * @code
+ * typedef Triangulation<double, LocatorSuperGrid<double> > Cdt;
+ * Cdt cdt(VertexInsertionOrder::Randomized, LocatorSuperGrid<double>(nx, ny));
+ * initializeWithRegularGrid(xmin, xmax, ymin, ymax, nx, ny, cdt);
+ * @endcode
+ *
+ * @tparam T type of vertex coordinates (e.g., float, double)
+ * @tparam TFallbackLocator locator for points inserted after the grid
+ */
+template <typename T, typename TFallbackLocator = LocatorKDTree<T> >
+class LocatorSuperGrid
+{
+public:
+    /// Default constructor: no grid
+    LocatorSuperGrid()
+        : m_xres(0)
+        , m_yres(0)
+        , m_nGridVertices(0)
+        , m_nOtherPoints(0)
+    {}
+    /**
+     * Constructor
+     * @param xres grid X-resolution
+     * @param yres grid Y-resolution
+     */
+    LocatorSuperGrid(const std::size_t xres, const std::size_t yres)
+        : m_xres(xres)
+        , m_yres(yres)
+        , m_nGridVertices((xres + 1) * (yres + 1))
+        , m_nOtherPoints(0)
+    {}
+    /// Add point: grid vertices are skipped, others go to fallback locator
+    void addPoint(const VertInd i, const std::vector<V2d<T> >& points)
+    {
+        if(i < m_nGridVertices)
+            return;
+        m_fallback.addPoint(i, points);
+        ++m_nOtherPoints;
+    }
+    /// Find near point: nearest of grid vertex and fallback's point
+    VertInd
+    nearPoint(const V2d<T>& pos, const std::vector<V2d<T> >& points) const
+    {
+        if(m_nGridVertices == 0)
+            return m_fallback.nearPoint(pos, points);
+        const detail::GridTickX<T> tickX = {points};
+        const detail::GridTickY<T> tickY = {points, m_xres};
+        std::size_t ix = detail::findTickInterval(pos.x, m_xres, tickX);
+        std::size_t iy = detail::findTickInterval(pos.y, m_yres, tickY);
+        // nearest corner of grid cell
+        if(pos.x - tickX(ix) > tickX(ix + 1) - pos.x)
+            ++ix;
+        if(pos.y - tickY(iy) > tickY(iy + 1) - pos.y)
+            ++iy;
+        const VertInd iGrid(iy * (m_xres + 1) + ix);
+        if(m_nOtherPoints == 0)
+            return iGrid;
+        const VertInd iOther = m_fallback.nearPoint(pos, points);
+        return distanceSquared(pos, points[iOther]) <
+                       distanceSquared(pos, points[iGrid])
+                   ? iOther
+                   : iGrid;
+    }
+
+private:
+    std::size_t m_xres;
+    std::size_t m_yres;
+    std::size_t m_nGridVertices;
+    std::size_t m_nOtherPoints;
+    TFallbackLocator m_fallback;
+};
+
 /**
  * Make a triangulation that uses regular grid triangles instead of
  * super-triangle
@@ -4,7 +4,7 @@
 
 /**
  * @file
- * Helper function to verify if triangulation has no inconsistencies
+ * Helper functions to verify if triangulation has no inconsistencies
  */
 
 #ifndef CDT_Zahj4kpHLwFgkKtcOI1i
@@ -13,63 +13,404 @@
 #include "CDT.h"
 
 #include <algorithm>
+#include <cstddef>
 
 namespace CDT
 {
 
+/// Kind of triangulation inconsistency found by verification
+struct CDT_EXPORT TriangulationError
+{
+    /// Enum
+    enum Enum
+    {
+        None, ///< no inconsistencies found
+        /// vertex has adjacent triangle that does not contain the vertex
+        VertexTriangles,
+        /// triangle's neighbor does not have triangle as a neighbor across
+        /// the same edge
+        NeighborLinks,
+        /// triangle's vertex does not have triangle as adjacent
+        TriangleVertices,
+        /// triangle's vertices are not counter-clockwise (or are collinear)
+        Orientation,
+        /// non-fixed edge is not locally Delaunay
+        NotDelaunay,
+        /// fixed edge is not an edge of the triangulation
+        MissingFixedEdge,
+    };
+};
+
+/// Result of triangulation verification: first found inconsistency
+struct CDT_EXPORT TriangulationDiagnostics
+{
+    TriangulationError::Enum error; ///< kind of inconsistency
+    /// offending triangle: triangle with the smallest index for which the
+    /// error was detected; noNeighbor if error is not about a triangle
+    TriInd iTriangle;
+    /// offending vertex for vertex errors, first vertex of the offending edge
+    /// for fixed-edge errors, noVertex otherwise
+    VertInd iVertex;
+    /// second vertex of the offending edge for fixed-edge errors, noVertex
+    /// otherwise
+    VertInd iVertex2;
+
+    /// If no inconsistencies were found
+    bool isOk() const
+    {
+        return error == TriangulationError::None;
+    }
+    /// Factory method
+    static TriangulationDiagnostics make(
+        const TriangulationError::Enum error,
+        const TriInd iTriangle = noNeighbor,
+        const VertInd iVertex = noVertex,
+        const VertInd iVertex2 = noVertex)
+    {
+        TriangulationDiagnostics d;
+        d.error = error;
+        d.iTriangle = iTriangle;
+        d.iVertex = iVertex;
+        d.iVertex2 = iVertex2;
+        return d;
+    }
+};
+
+namespace detail
+{
+
 /**
- * Verify that triangulation topology is consistent.
- *
- * Checks:
- *  - for each vertex adjacent triangles contain the vertex
- *  - each triangle's neighbor in turn has triangle as its neighbor
- *  - each of triangle's vertices has triangle as adjacent
+ * Find smallest index in [0, n) for which predicate is true or n if none
  *
- * @tparam T type of vertex coordinates (e.g., float, double)
- * @tparam TNearPointLocator class providing locating near point for efficiently
+ * Runs in parallel for large n when OpenMP is enabled
  */
-template <typename T, typename TNearPointLocator = LocatorKDTree<T> >
-inline bool verifyTopology(const CDT::Triangulation<T, TNearPointLocator>& cdt)
+template <typename TPredicate>
+std::size_t findFirstOffending(const std::size_t n, const TPredicate& isBad)
 {
-    // Check if vertices' adjacent triangles contain vertex
-    for(VertInd iV(0); iV < VertInd(cdt.vertices.size()); ++iV)
+    std::ptrdiff_t iFirst = static_cast<std::ptrdiff_t>(n);
+#ifdef _OPENMP
+#pragma omp parallel for if(iFirst >= minParallelLoopSize)
+#endif
+    for(std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(n); ++i)
     {
+        if(!isBad(i))
+            continue;
+#ifdef _OPENMP
+#pragma omp critical(CDT_findFirstOffending)
+#endif
+        {
+            if(i < iFirst)
+                iFirst = i;
+        }
+    }
+    return static_cast<std::size_t>(iFirst);
+}
+
+/// Vertex has adjacent triangle that does not contain it
+template <typename T, typename TNearPointLocator>
+struct HasBadVertexTriangles
+{
+    const Triangulation<T, TNearPointLocator>& cdt; ///< triangulation
+    /// Predicate
+    bool operator()(const std::ptrdiff_t i) const
+    {
+        const VertInd iV(static_cast<VertInd>(i));
         const TriIndVec& vTris = cdt.vertTris[iV];
         typedef TriIndVec::const_iterator TriIndCit;
         for(TriIndCit it = vTris.begin(); it != vTris.end(); ++it)
-        {
-            const array<VertInd, 3>& vv = cdt.triangles[*it].vertices;
-            if(std::find(vv.begin(), vv.end(), iV) == vv.end())
-                return false;
-        }
+            if(isBadTriangle(iV, *it))
+                return true;
+        return false;
     }
-    // Check if triangle neighbor links are fine
-    for(TriInd iT(0); iT < TriInd(cdt.triangles.size()); ++iT)
+    /// If vertex's adjacent triangle does not contain the vertex
+    bool isBadTriangle(const VertInd iV, const TriInd iT) const
+    {
+        if(iT >= cdt.triangles.size())
+            return true;
+        const VerticesArr3& vv = cdt.triangles[iT].vertices;
+        return std::find(vv.begin(), vv.end(), iV) == vv.end();
+    }
+};
+
+/// Triangle's neighbor links are not mutual or are across different edges
+template <typename T, typename TNearPointLocator>
+struct HasBadNeighborLinks
+{
+    const Triangulation<T, TNearPointLocator>& cdt; ///< triangulation
+    /// Predicate
+    bool operator()(const std::ptrdiff_t i) const
     {
+        const TriInd iT(static_cast<TriInd>(i));
         const Triangle& t = cdt.triangles[iT];
-        typedef NeighborsArr3::const_iterator NCit;
-        for(NCit it = t.neighbors.begin(); it != t.neighbors.end(); ++it)
+        for(Index j(0); j < Index(3); ++j)
         {
-            if(*it == noNeighbor)
+            const TriInd iTn = t.neighbors[j];
+            if(iTn == noNeighbor)
                 continue;
-            const array<TriInd, 3>& nn = cdt.triangles[*it].neighbors;
-            if(std::find(nn.begin(), nn.end(), iT) == nn.end())
-                return false;
+            if(iTn >= cdt.triangles.size())
+                return true;
+            const Triangle& tn = cdt.triangles[iTn];
+            const NeighborsArr3& nn = tn.neighbors;
+            const NeighborsArr3::const_iterator itN =
+                std::find(nn.begin(), nn.end(), iT);
+            if(itN == nn.end())
+                return true;
+            const Index jn = Index(itN - nn.begin());
+            // neighbor's shared edge has the opposite direction
+            if(tn.vertices[jn] != t.vertices[ccw(j)] ||
+               tn.vertices[ccw(jn)] != t.vertices[j])
+            {
+                return true;
+            }
         }
+        return false;
     }
-    // Check if triangle's vertices have triangle as adjacent
-    for(TriInd iT(0); iT < TriInd(cdt.triangles.size()); ++iT)
+};
+
+/// Triangle's vertex does not have triangle as adjacent
+template <typename T, typename TNearPointLocator>
+struct HasBadTriangleVertices
+{
+    const Triangulation<T, TNearPointLocator>& cdt; ///< triangulation
+    /// Predicate
+    bool operator()(const std::ptrdiff_t i) const
     {
-        const Triangle& t = cdt.triangles[iT];
-        typedef VerticesArr3::const_iterator VCit;
-        for(VCit it = t.vertices.begin(); it != t.vertices.end(); ++it)
+        const TriInd iT(static_cast<TriInd>(i));
+        const VerticesArr3& vv = cdt.triangles[iT].vertices;
+        for(VerticesArr3::const_iterator it = vv.begin(); it != vv.end(); ++it)
         {
+            if(*it == ghostVertex)
+                continue;
+            if(*it >= cdt.vertTris.size())
+                return true;
             const TriIndVec& tt = cdt.vertTris[*it];
             if(std::find(tt.begin(), tt.end(), iT) == tt.end())
+                return true;
+        }
+        return false;
+    }
+};
+
+/// Triangle is not counter-clockwise (ghost triangles are not checked)
+template <typename T, typename TNearPointLocator>
+struct HasBadOrientation
+{
+    const Triangulation<T, TNearPointLocator>& cdt; ///< triangulation
+    /// Predicate
+    bool operator()(const std::ptrdiff_t i) const
+    {
+        const VerticesArr3& vv = cdt.triangles[i].vertices;
+        if(std::find(vv.begin(), vv.end(), ghostVertex) != vv.end())
+            return false;
+        return locatePointLine(
+                   cdt.vertices[vv[2]],
+                   cdt.vertices[vv[0]],
+                   cdt.vertices[vv[1]]) != PtLineLocation::Left;
+    }
+};
+
+/**
+ * Triangle has a non-fixed edge that is not locally Delaunay: vertex of the
+ * neighbor across the edge is inside triangle's circumcircle
+ *
+ * Each edge is checked from the triangle with the smaller index. Edges of
+ * triangles touching super-triangle vertices or ghost vertex are skipped:
+ * these follow different rules.
+ */
+template <typename T, typename TNearPointLocator>
+struct HasNonDelaunayEdge
+{
+    const Triangulation<T, TNearPointLocator>& cdt; ///< triangulation
+    bool hasSuperTriangle; ///< skip vertices of the super-triangle
+    /// Predicate
+    bool operator()(const std::ptrdiff_t i) const
+    {
+        const TriInd iT(static_cast<TriInd>(i));
+        const Triangle& t = cdt.triangles[iT];
+        const VerticesArr3& vv = t.vertices;
+        if(isSuper(vv[0]) || isSuper(vv[1]) || isSuper(vv[2]))
+            return false;
+        for(Index j(0); j < Index(3); ++j)
+        {
+            const TriInd iTn = t.neighbors[j];
+            if(iTn == noNeighbor || iTn < iT)
+                continue;
+            if(cdt.fixedEdges.count(Edge(vv[j], vv[ccw(j)])))
+                continue;
+            const VertInd iVopo = opposedVertex(cdt.triangles[iTn], iT);
+            if(isSuper(iVopo))
+                continue;
+            if(isInCircumcircle(
+                   cdt.vertices[iVopo],
+                   cdt.vertices[vv[0]],
+                   cdt.vertices[vv[1]],
+                   cdt.vertices[vv[2]]))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    bool isSuper(const VertInd iV) const
+    {
+        return iV == ghostVertex || (hasSuperTriangle && iV < 3);
+    }
+};
+
+/**
+ * Fixed edge is not an edge of any triangle
+ *
+ * Dangling fixed edges are skipped: fixed edges outside of remaining
+ * triangles after erasing outer triangles or holes (e.g., hanging
+ * constraints) have no bordering triangle. Edge is dangling if both of its
+ * vertices are on the boundary of the triangulation or have no triangles.
+ */
+template <typename T, typename TNearPointLocator>
+struct IsFixedEdgeMissing
+{
+    const Triangulation<T, TNearPointLocator>& cdt; ///< triangulation
+    /// Predicate
+    bool operator()(const std::ptrdiff_t i) const
+    {
+        const Edge& e = *(cdt.fixedEdges.begin() + i);
+        if(e.v1() >= cdt.vertTris.size() || e.v2() >= cdt.vertTris.size())
+            return true;
+        const TriIndVec& tt = cdt.vertTris[e.v1()];
+        for(TriIndVec::const_iterator it = tt.begin(); it != tt.end(); ++it)
+        {
+            const VerticesArr3& vv = cdt.triangles[*it].vertices;
+            if(std::find(vv.begin(), vv.end(), e.v2()) != vv.end())
                 return false;
         }
+        return !isBoundaryOrIsolated(e.v1()) || !isBoundaryOrIsolated(e.v2());
+    }
+
+private:
+    bool isBoundaryOrIsolated(const VertInd iV) const
+    {
+        const TriIndVec& tt = cdt.vertTris[iV];
+        for(TriIndVec::const_iterator it = tt.begin(); it != tt.end(); ++it)
+        {
+            const Triangle& t = cdt.triangles[*it];
+            const Index j = vertexInd(t, iV);
+            if(t.neighbors[j] == noNeighbor || t.neighbors[cw(j)] == noNeighbor)
+                return true;
+        }
+        return tt.empty();
+    }
+};
+
+/// Run topology checks, stops at the first failing check
+template <typename T, typename TNearPointLocator>
+TriangulationDiagnostics
+verifyTopology(const Triangulation<T, TNearPointLocator>& cdt)
+{
+    const std::size_t nV = cdt.vertTris.size();
+    const std::size_t nT = cdt.triangles.size();
+    const HasBadVertexTriangles<T, TNearPointLocator> vertexTris = {cdt};
+    std::size_t i = findFirstOffending(nV, vertexTris);
+    if(i != nV)
+    {
+        TriIndVec::const_iterator it = cdt.vertTris[i].begin();
+        while(!vertexTris.isBadTriangle(VertInd(i), *it))
+            ++it;
+        return TriangulationDiagnostics::make(
+            TriangulationError::VertexTriangles, *it, VertInd(i));
+    }
+    const HasBadNeighborLinks<T, TNearPointLocator> nbrLinks = {cdt};
+    i = findFirstOffending(nT, nbrLinks);
+    if(i != nT)
+    {
+        return TriangulationDiagnostics::make(
+            TriangulationError::NeighborLinks, TriInd(i));
+    }
+    const HasBadTriangleVertices<T, TNearPointLocator> triVerts = {cdt};
+    i = findFirstOffending(nT, triVerts);
+    if(i != nT)
+    {
+        return TriangulationDiagnostics::make(
+            TriangulationError::TriangleVertices, TriInd(i));
+    }
+    return TriangulationDiagnostics::make(TriangulationError::None);
+}
+
+} // namespace detail
+
+/**
+ * Verify that triangulation topology is consistent.
+ *
+ * Checks:
+ *  - for each vertex adjacent triangles contain the vertex
+ *  - each triangle's neighbor in turn has triangle as its neighbor
+ *  - each of triangle's vertices has triangle as adjacent
+ *
+ * @note runs in parallel for large triangulations if OpenMP is enabled
+ * @tparam T type of vertex coordinates (e.g., float, double)
+ * @tparam TNearPointLocator class providing locating near point for efficiently
+ */
+template <typename T, typename TNearPointLocator = LocatorKDTree<T> >
+inline bool verifyTopology(const CDT::Triangulation<T, TNearPointLocator>& cdt)
+{
+    return detail::verifyTopology(cdt).isOk();
+}
+
+/**
+ * Verify that triangulation is a consistent constrained Delaunay
+ * triangulation.
+ *
+ * Checks (in this order, the first failing check is reported):
+ *  - topology checks of @ref verifyTopology (additionally neighbors must be
+ *    linked across the same edge)
+ *  - each triangle is counter-clockwise
+ *  - each edge that is not fixed is locally Delaunay: opposed vertex of the
+ *    neighbor triangle is not inside triangle's circumcircle. Edges touching
+ *    vertices of a not yet erased super-triangle or ghost vertex are not
+ *    checked.
+ *  - each fixed edge is an edge of the triangulation. Dangling fixed edges
+ *    left outside of the triangulation by erasing outer triangles or holes
+ *    (both vertices on the boundary or without triangles) are not checked.
+ *
+ * @note runs in parallel for large triangulations if OpenMP is enabled
+ * @tparam T type of vertex coordinates (e.g., float, double)
+ * @tparam TNearPointLocator class providing locating near point for efficiently
+ * @returns first found inconsistency with offending triangle (the one with the
+ * smallest index) or @ref TriangulationError::None
+ */
+template <typename T, typename TNearPointLocator = LocatorKDTree<T> >
+inline TriangulationDiagnostics
+verifyTriangulation(const CDT::Triangulation<T, TNearPointLocator>& cdt)
+{
+    const TriangulationDiagnostics topology = detail::verifyTopology(cdt);
+    if(!topology.isOk())
+        return topology;
+    const std::size_t nT = cdt.triangles.size();
+    const detail::HasBadOrientation<T, TNearPointLocator> orientation = {cdt};
+    std::size_t i = detail::findFirstOffending(nT, orientation);
+    if(i != nT)
+    {
+        return TriangulationDiagnostics::make(
+            TriangulationError::Orientation, TriInd(i));
+    }
+    const detail::HasNonDelaunayEdge<T, TNearPointLocator> delaunay = {
+        cdt, cdt.hasSuperTriangle()};
+    i = detail::findFirstOffending(nT, delaunay);
+    if(i != nT)
+    {
+        return TriangulationDiagnostics::make(
+            TriangulationError::NotDelaunay, TriInd(i));
+    }
+    const std::size_t nE = cdt.fixedEdges.size();
+    const detail::IsFixedEdgeMissing<T, TNearPointLocator> fixedEdges = {cdt};
+    i = detail::findFirstOffending(nE, fixedEdges);
+    if(i != nE)
+    {
+        const Edge& e = *(cdt.fixedEdges.begin() + i);
+        return TriangulationDiagnostics::make(
+            TriangulationError::MissingFixedEdge, noNeighbor, e.v1(), e.v2());
     }
-    return true;
+    return TriangulationDiagnostics::make(TriangulationError::None);
 }
 
 } // namespace CDT
@@ -21,9 +21,14 @@
 #include <limits>
 #include <memory>
 #include <stack>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace CDT
 {
 
@@ -57,6 +62,55 @@ struct CDT_EXPORT SuperGeometryType
     {
         SuperTriangle, ///< conventional super-triangle
         Custom,        ///< user-specified custom geometry (e.g., grid)
+        /**
+         * single symbolic vertex at infinity (@ref ghostVertex) connected to
+         * each convex hull edge by a ghost triangle: vertex indices match the
+         * input indices and convex hull is available without erasing anything
+         */
+        GhostVertex,
+    };
+};
+
+/// Enum of methods used for inserting constraint edges
+struct CDT_EXPORT ConstraintInsertionMethod
+{
+    /**
+     * The Enum itself
+     * @note needed to pre c++11 compilers that don't support 'class enum'
+     */
+    enum Enum
+    {
+        /**
+         * intersected triangles are removed and the pseudo-polygons on both
+         * sides of the edge are re-triangulated
+         */
+        Retriangulation,
+        /**
+         * intersected edges are flipped until the edge appears and then the
+         * new edges are flipped until they are Delaunay (Sloan): touches less
+         * memory when edges intersect a few triangles
+         */
+        EdgeFlips,
+    };
+};
+
+/// Enum of strategies for treating intersecting constraint edges
+struct CDT_EXPORT IntersectingConstraintEdges
+{
+    /**
+     * The Enum itself
+     * @note needed to pre c++11 compilers that don't support 'class enum'
+     */
+    enum Enum
+    {
+        /// constraint edges are assumed not to intersect (not checked)
+        Ignore,
+        /**
+         * fixed edge crossed by an inserted edge is detected while walking
+         * the intersected triangles: vertex is inserted at the intersection
+         * and both edges are split there (see @ref Triangulation::insertEdges)
+         */
+        Resolve,
     };
 };
 
@@ -64,6 +118,8 @@ struct CDT_EXPORT SuperGeometryType
 const static TriInd noNeighbor(std::numeric_limits<TriInd>::max());
 /// Constant representing no valid vertex for a triangle
 const static VertInd noVertex(std::numeric_limits<VertInd>::max());
+/// Symbolic vertex at infinity of ghost triangles (has no coordinates)
+const static VertInd ghostVertex(std::numeric_limits<VertInd>::max() - 1);
 
 /**
  * Type used for storing layer depths for triangles
@@ -72,6 +128,119 @@ const static VertInd noVertex(std::numeric_limits<VertInd>::max());
  */
 typedef unsigned short LayerDepth;
 typedef LayerDepth BoundaryOverlapCount;
+/// Hash map of boundary overlap counts at fixed edges
+typedef FlatHashMap<Edge, BoundaryOverlapCount, EdgeHash> EdgeOverlapCountUMap;
+/// Hash map from edges to lists of edges
+typedef FlatHashMap<Edge, std::vector<Edge>, EdgeHash> EdgeToEdgesUMap;
+/// Hash map from edges to lists of vertices
+typedef FlatHashMap<Edge, std::vector<VertInd>, EdgeHash> EdgeToVerticesUMap;
+
+/**
+ * Layer depth and region of each triangle (see
+ * @ref Triangulation::calculateTriangleRegions)
+ *
+ * Region is a connected component of triangles bounded by fixed edges.
+ * Regions are numbered in the order of depth peeling: region 0 is outside of
+ * the outermost boundary. Triangles can be filtered lazily without erasing,
+ * e.g., triangle iT is inside the constrained domain (not outside and not in
+ * a hole) if depths[iT] is odd.
+ */
+struct CDT_EXPORT TriangleRegions
+{
+    std::vector<LayerDepth> depths;       ///< layer depth of each triangle
+    std::vector<TriInd> regions;          ///< region of each triangle
+    std::vector<LayerDepth> regionDepths; ///< layer depth of each region
+};
+
+namespace detail
+{
+
+/// Buffers re-used between pseudo-polygon triangulations
+struct PseudopolyBuffers
+{
+    /// Pending step of pseudo-polygon triangulation: edge and triangle
+    struct Step
+    {
+        VertInd v1; ///< first vertex of the edge
+        VertInd v2; ///< second vertex of the edge
+        TriInd iT;  ///< triangle adjacent to the edge
+        /// Constructor
+        Step(const VertInd v1_, const VertInd v2_, const TriInd iT_)
+            : v1(v1_)
+            , v2(v2_)
+            , iT(iT_)
+        {}
+    };
+
+    std::vector<VertInd> vertices; ///< local to triangulation vertex index
+    std::vector<bool> isInChain;   ///< marks for finding repeated vertices
+    std::vector<VertInd> prev;     ///< previous vertex in polygon's chain
+    std::vector<VertInd> next;     ///< next vertex in polygon's chain
+    std::vector<VertInd> order;    ///< randomized vertex insertion order
+    std::vector<TriInd> chainTris; ///< triangles at polygon chain's edges
+    std::vector<TriInd> triInds;   ///< local to triangulation triangle index
+    TriangleVec triangles;         ///< triangles with local vertex indices
+    std::vector<Step> steps;       ///< stack of pending steps
+    unsigned long long randState;  ///< state of random number generator
+
+    /// Constructor
+    PseudopolyBuffers()
+        : randState(0)
+    {}
+};
+
+/// Buffers re-used between constraint insertions by flipping edges
+struct EdgeFlipBuffers
+{
+    std::vector<Edge> intersected; ///< edges intersected by the constraint
+    std::vector<Edge> postponed;   ///< edges to flip in the next pass
+    std::vector<Edge> newEdges;    ///< flipped edges to make Delaunay
+};
+
+/**
+ * Triangles around high-degree vertices ordered counter-clockwise. Re-used
+ * between constraint insertions, a vertex is cached in slot (index % size).
+ */
+struct VertexStarCache
+{
+    std::vector<VertInd> vertices;           ///< vertex or no-vertex per slot
+    std::vector<std::vector<TriInd> > stars; ///< empty if star is open
+
+    /// Constructor
+    VertexStarCache()
+        : vertices(16, noVertex)
+        , stars(16)
+    {}
+    /// Invalidate all slots
+    void clear()
+    {
+        std::fill(vertices.begin(), vertices.end(), noVertex);
+    }
+};
+
+/**
+ * Buffers and state of inserting constraint edges by re-triangulation. Each
+ * thread has its own context when edges are inserted in parallel: removed
+ * triangles are re-used locally and fixing the edges is postponed.
+ */
+struct EdgeInsertionContext
+{
+    PseudopolyBuffers pseudopoly; ///< pseudo-polygon triangulation buffers
+    VertexStarCache vertexStars;  ///< ordered stars of high-degree vertices
+    bool isParallel;              ///< edge is inserted in parallel with others
+    std::size_t iEdge;            ///< order of edge inserted in parallel
+    std::vector<TriInd> dummyTris; ///< triangles removed in parallel
+    /// Postponed fixed edges and orders of edges they belong to
+    std::vector<std::pair<std::size_t, Edge> > fixedEdges;
+
+    /// Constructor
+    EdgeInsertionContext()
+        : isParallel(false)
+        , iEdge(0)
+    {}
+};
+
+} // namespace detail
 
 /**
  * Data structure representing a 2D constrained Delaunay triangulation
@@ -99,7 +268,17 @@ public:
      * @note needed for handling depth calculations and hole-removel in case of
      * overlapping boundaries
      */
-    unordered_map<Edge, BoundaryOverlapCount> overlapCount;
+    EdgeOverlapCountUMap overlapCount;
+
+    /** Stores original constraint edges represented by a fixed edge (piece).
+     * If no entry is present for a fixed edge: it represents only itself.
+     * @note map only has entries for pieces of constraint edges that were
+     * split by vertices on the edge, by inserted vertices, or by intersections
+     * with other constraint edges
+     * @note use @ref EdgeToPiecesMapping and @ref EdgeToSplitVertices to get
+     * pieces of each split constraint edge
+     */
+    EdgeToEdgesUMap pieceToOriginals;
 
     /*____ API _____*/
     /// Default constructor
@@ -118,8 +297,69 @@ public:
     Triangulation(
         VertexInsertionOrder::Enum vertexInsertionOrder,
         const TNearPointLocator& nearPtLocator);
+    /**
+     * Constructor
+     * @param vertexInsertionOrder strategy used for ordering vertex insertions
+     * @param nearPtLocator class providing locating near point for efficiently
+     * inserting new points
+     * @param superGeomType geometry enclosing inserted vertices:
+     * @ref SuperGeometryType::SuperTriangle or
+     * @ref SuperGeometryType::GhostVertex
+     * @note with ghost vertex triangles contain @ref ghostVertex until
+     * @ref eraseSuperTriangle, @ref eraseOuterTriangles or
+     * @ref eraseOuterTrianglesAndHoles is called. The first batch of inserted
+     * vertices must not be all collinear: otherwise an exception is thrown
+     * and triangulation is left unchanged.
+     */
+    Triangulation(
+        VertexInsertionOrder::Enum vertexInsertionOrder,
+        const TNearPointLocator& nearPtLocator,
+        SuperGeometryType::Enum superGeomType);
+    /**
+     * Constructor
+     * @param vertexInsertionOrder strategy used for ordering vertex insertions
+     * @param nearPtLocator class providing locating near point for efficiently
+     * inserting new points
+     * @param superGeomType geometry enclosing inserted vertices:
+     * @ref SuperGeometryType::SuperTriangle or
+     * @ref SuperGeometryType::GhostVertex
+     * @param constraintInsertionMethod method used for inserting constraint
+     * edges
+     */
+    Triangulation(
+        VertexInsertionOrder::Enum vertexInsertionOrder,
+        const TNearPointLocator& nearPtLocator,
+        SuperGeometryType::Enum superGeomType,
+        ConstraintInsertionMethod::Enum constraintInsertionMethod);
+    /**
+     * Constructor
+     * @param vertexInsertionOrder strategy used for ordering vertex insertions
+     * @param nearPtLocator class providing locating near point for efficiently
+     * inserting new points
+     * @param superGeomType geometry enclosing inserted vertices:
+     * @ref SuperGeometryType::SuperTriangle or
+     * @ref SuperGeometryType::GhostVertex
+     * @param constraintInsertionMethod method used for inserting constraint
+     * edges
+     * @param intersectingEdgesStrategy strategy for treating intersecting
+     * constraint edges
+     */
+    Triangulation(
+        VertexInsertionOrder::Enum vertexInsertionOrder,
+        const TNearPointLocator& nearPtLocator,
+        SuperGeometryType::Enum superGeomType,
+        ConstraintInsertionMethod::Enum constraintInsertionMethod,
+        IntersectingConstraintEdges::Enum intersectingEdgesStrategy);
     /**
      * Insert custom point-types specified by iterator range and X/Y-getters
+     *
+     * Vertices outside of the current super-triangle are supported: then the
+     * super-triangle is replaced with ghost vertex (see
+     * @ref SuperGeometryType::GhostVertex) and the convex hull grows as
+     * vertices are added. Super-triangle vertices stay in @ref vertices
+     * without adjacent triangles until @ref eraseSuperTriangle (or other
+     * erase method) is called.
+     * Vertices inserted after constraint edges do not flip fixed edges.
      * @tparam TVertexIter iterator that dereferences to custom point type
      * @tparam TGetVertexCoordX function object getting x coordinate from
      * vertex. Getter signature: const TVertexIter::value_type& -> T
@@ -157,6 +397,21 @@ public:
      * @param last end of the range of edges to add
      * @param getStart getter of edge start vertex index
      * @param getEnd getter of edge end vertex index
+     * @note With IntersectingConstraintEdges::Resolve an inserted edge
+     * crossing an already fixed edge splits both edges at a new vertex (see
+     * @ref intersectionPosition for the rounding of its position). The
+     * halves keep the overlap counts of the split edges. Vertex is connected
+     * as if it lies exactly on both edges: vertices within its rounding error
+     * of an inserted edge are treated as lying on the edge (see
+     * @ref isWithinRoundingError).
+     * @note Edges split into several fixed edges (pieces) are recorded in
+     * @ref pieceToOriginals
+     * @note When OpenMP is enabled and more than one thread is available
+     * large inputs are inserted in parallel (only with
+     * ConstraintInsertionMethod::Retriangulation and without resolving
+     * intersecting edges): edges intersecting
+     * triangles without common vertices are inserted concurrently. Fixed
+     * edges and overlap counts are the same as with sequential insertion.
      */
     template <
         typename TEdgeIter,
@@ -176,9 +431,74 @@ public:
      */
     void insertEdges(const std::vector<Edge>& edges);
     /**
-     * Erase triangles adjacent to super triangle
+     * Insert open polyline constraint given by custom point-type coordinates:
+     * inserts polyline vertices and fixed edges between consecutive vertices
+     *
+     * Vertices are inserted in polyline order (regardless of vertex insertion
+     * order): search for each vertex starts at the previous one. Point
+     * coinciding with an existing vertex (or a previous polyline point) is
+     * welded to it instead of being inserted.
+     * @note polylines crossing each other or existing constraints are not
+     * supported (same as for @ref insertEdges)
+     * @note vertices of custom super-geometry (e.g., from
+     * @ref initializeWithRegularGrid) can't be welded to: an exception is
+     * thrown if a point coincides with such vertex or it is the closest
+     * vertex within welding distance. Points inserted before the throw
+     * remain triangulation vertices.
+     * @tparam TVertexIter iterator that dereferences to custom point type
+     * @tparam TGetVertexCoordX function object getting x coordinate from
+     * vertex. Getter signature: const TVertexIter::value_type& -> T
+     * @tparam TGetVertexCoordY function object getting y coordinate from
+     * vertex. Getter signature: const TVertexIter::value_type& -> T
+     * @param first beginning of the range of polyline points
+     * @param last end of the range of polyline points
+     * @param getX getter of X-coordinate
+     * @param getY getter of Y-coordinate
+     * @param weldEpsilon points closer than this distance to an existing
+     * vertex are welded to it
+     * @returns indices of vertices of polyline points (same indexing as
+     * edges in @ref insertEdges)
+     */
+    template <
+        typename TVertexIter,
+        typename TGetVertexCoordX,
+        typename TGetVertexCoordY>
+    std::vector<VertInd> insertPolyline(
+        TVertexIter first,
+        TVertexIter last,
+        TGetVertexCoordX getX,
+        TGetVertexCoordY getY,
+        T weldEpsilon = T(0));
+    /// Insert open polyline constraint (see @ref insertPolyline)
+    std::vector<VertInd> insertPolyline(
+        const std::vector<V2d<T> >& points,
+        T weldEpsilon = T(0));
+    /**
+     * Insert closed ring constraint: same as @ref insertPolyline with
+     * additional fixed edge from the last point to the first one
+     * @note last point repeating the first one is welded to it
+     */
+    template <
+        typename TVertexIter,
+        typename TGetVertexCoordX,
+        typename TGetVertexCoordY>
+    std::vector<VertInd> insertRing(
+        TVertexIter first,
+        TVertexIter last,
+        TGetVertexCoordX getX,
+        TGetVertexCoordY getY,
+        T weldEpsilon = T(0));
+    /// Insert closed ring constraint (see @ref insertRing)
+    std::vector<VertInd>
+    insertRing(const std::vector<V2d<T> >& points, T weldEpsilon = T(0));
+    /**
+     * Erase triangles adjacent to super triangle (or ghost triangles)
      *
      * @note does nothing if custom geometry is used
+     * @note erasing super-triangle (also by @ref eraseOuterTriangles and
+     * @ref eraseOuterTrianglesAndHoles) makes remaining triangulation a
+     * custom geometry: @ref hasSuperTriangle returns false and edges
+     * inserted afterwards use the same vertex indices as @ref fixedEdges
      */
     void eraseSuperTriangle();
     /// Erase triangles outside of constrained boundary using growing
@@ -190,23 +510,117 @@ public:
      * @note supports overlapping or touching boundaries
      */
     void eraseOuterTrianglesAndHoles();
+    /**
+     * Calculate layer depth and region of each triangle without erasing
+     * triangles
+     *
+     * Depths are the same as used by @ref eraseOuterTrianglesAndHoles (even
+     * depths are outside or in holes). Regions are found in the same
+     * depth-peeling pass.
+     * @note call before erasing super-triangle (or ghost triangles):
+     * depth-peeling starts from them
+     * @note results are indexed as @ref triangles and are invalidated when
+     * triangles change
+     */
+    TriangleRegions calculateTriangleRegions() const;
     /**
      * Call this method after directly setting custom super-geometry via
      * vertices and triangles members
      */
     void initializedWithCustomSuperGeometry();
+    /**
+     * If triangulation contains the vertices of a conventional super-triangle
+     * (first three vertices) that were not erased yet
+     */
+    bool hasSuperTriangle() const;
+    /**
+     * Vertices of the convex hull in counter-clockwise order
+     *
+     * Walks around the ghost triangles: O(h) for h hull vertices
+     * @note returns empty vector unless ghost vertex is used and ghost
+     * triangles were not erased yet
+     */
+    std::vector<VertInd> convexHull() const;
 
 private:
     /*____ Detail __*/
     void addSuperTriangle(const Box2d<T>& box);
+    std::vector<VertInd>::const_iterator
+    addGhostTriangles(std::vector<VertInd>& iVerts);
+    void replaceSuperTriangleWithGhostVertex();
+    TriInd nextLinkTriangle(const TriInd iT) const;
+    TriInd
+    fillLinkCorner(const VertInd iV, const TriInd iT1, const TriInd iT2);
+    void flipEdgesUntilDelaunay(std::vector<Edge>& edges);
+    std::vector<TriInd> ghostTriangles() const;
+    bool isGhost(const TriInd iT) const;
     void addNewVertex(const V2d<T>& pos, const TriIndVec& tris);
+    template <
+        typename TVertexIter,
+        typename TGetVertexCoordX,
+        typename TGetVertexCoordY>
+    void prepareToInsertVertices(
+        TVertexIter first,
+        TVertexIter last,
+        TGetVertexCoordX getX,
+        TGetVertexCoordY getY);
+    template <
+        typename TVertexIter,
+        typename TGetVertexCoordX,
+        typename TGetVertexCoordY>
+    std::vector<VertInd> insertChain(
+        TVertexIter first,
+        TVertexIter last,
+        TGetVertexCoordX getX,
+        TGetVertexCoordY getY,
+        bool isClosed,
+        T weldEpsilon);
     void insertVertex(const VertInd iVert);
-    void insertEdge(Edge edge);
+    void insertVertex(const VertInd iVert, const array<TriInd, 2>& trisAt);
+    PtLineLocation::Enum locateEdgeVertex(
+        const VertInd iV,
+        const V2d<T>& a,
+        const V2d<T>& b) const;
+    void snapToEdge(
+        TriInd& iT,
+        VertInd& iVleft,
+        const VertInd iVright,
+        const V2d<T>& a,
+        const V2d<T>& b) const;
+    bool isCrossingFixedEdge(const TriInd iT, const VertInd iV) const;
+    VertInd insertIntersectionVertex(
+        const VertInd iA,
+        const VertInd iB,
+        const TriInd iT,
+        const TriInd iTopo);
+    VertInd insertChainVertex(
+        const V2d<T>& pos,
+        const VertInd iPrev,
+        const T weldEpsilon);
+    void insertEdge(
+        Edge edge,
+        const Edge originalEdge,
+        detail::EdgeInsertionContext& ctx);
+    void insertEdgeFlipping(Edge edge, const Edge originalEdge);
+    void insertEdgesInParallel(std::vector<Edge>& edges);
+    void edgeCorridorVertices(
+        Edge edge,
+        detail::VertexStarCache& stars,
+        std::vector<VertInd>& corridor) const;
+    TriInd edgeTriangle(const VertInd iV1, const VertInd iV2) const;
+    bool hasEdge(const VertInd iV1, const VertInd iV2) const;
     tuple<TriInd, VertInd, VertInd> intersectedTriangle(
         const VertInd iA,
-        const std::vector<TriInd>& candidates,
         const V2d<T>& a,
-        const V2d<T>& b) const;
+        const V2d<T>& b,
+        detail::VertexStarCache& stars) const;
+    bool orderedVertexStar(const VertInd iV, std::vector<TriInd>& star) const;
+    bool searchVertexStar(
+        const VertInd iA,
+        const V2d<T>& a,
+        const V2d<T>& b,
+        const std::vector<TriInd>& star,
+        tuple<TriInd, VertInd, VertInd>& out) const;
     /// Returns indices of three resulting triangles
     std::stack<TriInd> insertPointInTriangle(const VertInd v, const TriInd iT);
     /// Returns indices of four resulting triangles
@@ -214,6 +628,9 @@ private:
     insertPointOnEdge(const VertInd v, const TriInd iT1, const TriInd iT2);
     array<TriInd, 2> trianglesAt(const V2d<T>& pos) const;
     array<TriInd, 2> walkingSearchTrianglesAt(const V2d<T>& pos) const;
+    array<TriInd, 2> walkingSearchTrianglesAt(
+        const V2d<T>& pos,
+        const VertInd startVertex) const;
     TriInd walkTriangles(const VertInd startVertex, const V2d<T>& pos) const;
     bool isFlipNeeded(
         const V2d<T>& pos,
@@ -246,27 +663,48 @@ private:
     TriInd triangulatePseudopolygon(
         const VertInd ia,
         const VertInd ib,
-        const std::vector<VertInd>& points);
-    VertInd findDelaunayPoint(
-        const VertInd ia,
-        const VertInd ib,
-        const std::vector<VertInd>& points) const;
+        const std::vector<VertInd>& points,
+        detail::EdgeInsertionContext& ctx);
+    void triangulatePseudopolygonSplitting(detail::PseudopolyBuffers& buf);
+    bool triangulatePseudopolygonRandomized(detail::PseudopolyBuffers& buf);
+    bool isPseudopolygonTriangulationDelaunay(
+        const detail::PseudopolyBuffers& buf) const;
+    TriInd addPseudopolygonTriangles(
+        detail::PseudopolyBuffers& buf,
+        std::vector<TriInd>& dummyTris);
     TriInd pseudopolyOuterTriangle(const VertInd ia, const VertInd ib) const;
     TriInd addTriangle(const Triangle& t); // note: invalidates iterators!
     TriInd addTriangle(); // note: invalidates triangle iterators!
+    TriInd addTriangle(std::vector<TriInd>& dummyTris);
     void makeDummy(const TriInd iT);
+    void makeDummy(const TriInd iT, std::vector<TriInd>& dummyTris);
     void eraseDummies();
     void eraseSuperTriangleVertices(); // no effect if custom geometry is used
+    TriInd outerSeedTriangle() const;
     template <typename TriIndexIter>
     void eraseTrianglesAtIndices(TriIndexIter first, TriIndexIter last);
-    TriIndUSet growToBoundary(std::stack<TriInd> seeds) const;
+    std::vector<TriInd> growToBoundary(std::vector<TriInd> seeds) const;
     void fixEdge(const Edge& edge);
+    void fixEdge(const Edge& edge, const Edge& originalEdge);
+    void fixEdge(
+        const Edge& edge,
+        const Edge& originalEdge,
+        detail::EdgeInsertionContext& ctx);
+    void splitFixedEdge(const Edge& edge, const VertInd iSplitVert);
+    unsigned char
+    edgeFlags(const TriInd iT, const VertInd iV1, const VertInd iV2) const;
 
     std::vector<TriInd> m_dummyTris;
+    std::vector<unsigned char> m_fixedEdgeMasks; // fixedEdges per triangle
     TNearPointLocator m_nearPtLocator;
     std::size_t m_nTargetVerts;
     SuperGeometryType::Enum m_superGeomType;
+    VertInd m_minVertex; // smallest (x,y) vertex: on hull with ghost vertex
+    detail::EdgeInsertionContext m_edgeInsertionContext;
+    detail::EdgeFlipBuffers m_edgeFlipBuffers;
     VertexInsertionOrder::Enum m_vertexInsertionOrder;
+    ConstraintInsertionMethod::Enum m_constraintInsertionMethod;
+    IntersectingConstraintEdges::Enum m_intersectingEdgesStrategy;
 };
 
 /**
@@ -307,6 +745,36 @@ CDT_EXPORT DuplicatesInfo FindDuplicates(
     TGetVertexCoordX getX,
     TGetVertexCoordY getY);
 
+/**
+ * Find duplicates in given custom point-type range by sorting points
+ *
+ * Same result as @ref FindDuplicates: duplicates are mapped to the first
+ * occurrence of a point. Points are sorted by coordinates in chunks sorted in
+ * parallel and then merged when OpenMP is enabled.
+ * @note single-threaded it is slower than hashing in @ref FindDuplicates
+ * @note coordinates must not be NaN
+ * @tparam TVertexIter iterator that dereferences to custom point type
+ * @tparam TGetVertexCoordX function object getting x coordinate from vertex.
+ * Getter signature: const TVertexIter::value_type& -> T
+ * @tparam TGetVertexCoordY function object getting y coordinate from vertex.
+ * Getter signature: const TVertexIter::value_type& -> T
+ * @param first beginning of the range of vertices
+ * @param last end of the range of vertices
+ * @param getX getter of X-coordinate
+ * @param getY getter of Y-coordinate
+ * @returns information about vertex duplicates
+ */
+template <
+    typename T,
+    typename TVertexIter,
+    typename TGetVertexCoordX,
+    typename TGetVertexCoordY>
+CDT_EXPORT DuplicatesInfo FindDuplicatesBySorting(
+    TVertexIter first,
+    TVertexIter last,
+    TGetVertexCoordX getX,
+    TGetVertexCoordY getY);
+
 /**
  * Remove duplicates in-place from vector of custom points
  * @tparam TVertexIter iterator that dereferences to custom point type
@@ -333,6 +801,7 @@ CDT_EXPORT DuplicatesInfo RemoveDuplicates(std::vector<V2d<T> >& vertices);
  * Remap vertex indices in edges (in-place) using given vertex-index mapping.
  *
  * @note Mapping can be a result of RemoveDuplicates function
+ * @note runs in parallel when OpenMP is enabled
  * @param[in,out] edges collection of edges to remap
  * @param mapping vertex-index mapping
  */
@@ -380,6 +849,92 @@ CDT_EXPORT DuplicatesInfo RemoveDuplicatesAndRemapEdges(
     std::vector<V2d<T> >& vertices,
     std::vector<Edge>& edges);
 
+/**
+ * Find near-duplicates in given custom point-type range: points closer than
+ * a given distance to a previous point are welded to that point
+ *
+ * Points are processed in input order, each point is either kept or mapped to
+ * the nearest kept point within epsilon. Kept points are stored in a hashed
+ * grid with cells of 2*epsilon size, so each point is only compared with the
+ * kept points in 2x2 cells closest to it: linear time for inputs without
+ * large clusters of points closer than epsilon.
+ * @note same as @ref FindDuplicates if epsilon is zero
+ * @note welding does not chain: every point is within epsilon of the point
+ * it is welded to
+ * @note coordinates divided by epsilon must fit into long long
+ * @tparam TVertexIter iterator that dereferences to custom point type
+ * @tparam TGetVertexCoordX function object getting x coordinate from vertex.
+ * Getter signature: const TVertexIter::value_type& -> T
+ * @tparam TGetVertexCoordY function object getting y coordinate from vertex.
+ * Getter signature: const TVertexIter::value_type& -> T
+ * @param first beginning of the range of vertices
+ * @param last end of the range of vertices
+ * @param epsilon points within this distance are welded
+ * @param getX getter of X-coordinate
+ * @param getY getter of Y-coordinate
+ * @returns information about welded vertices (same as for duplicates)
+ */
+template <
+    typename T,
+    typename TVertexIter,
+    typename TGetVertexCoordX,
+    typename TGetVertexCoordY>
+CDT_EXPORT DuplicatesInfo FindNearDuplicates(
+    TVertexIter first,
+    TVertexIter last,
+    T epsilon,
+    TGetVertexCoordX getX,
+    TGetVertexCoordY getY);
+
+/**
+ * Weld points closer than epsilon (see @ref FindNearDuplicates), remove
+ * welded points from vector (in-place), remap edges (in-place) and remove
+ * edges that collapsed to zero length
+ *
+ * @note edges welded into the same edge are kept: they will be treated as
+ * overlapping boundaries
+ * @tparam T type of vertex coordinates (e.g., float, double)
+ * @tparam TVertex type of vertex
+ * @tparam TGetVertexCoordX function object getting x coordinate from vertex.
+ * Getter signature: const TVertexIter::value_type& -> T
+ * @tparam TGetVertexCoordY function object getting y coordinate from vertex.
+ * Getter signature: const TVertexIter::value_type& -> T
+ * @param[in, out] vertices vertices to remove welded points from
+ * @param[in, out] edges collection of edges connecting vertices
+ * @param epsilon points within this distance are welded
+ * @param getX getter of X-coordinate
+ * @param getY getter of Y-coordinate
+ * @returns information about welded vertices
+ */
+template <
+    typename T,
+    typename TVertex,
+    typename TGetVertexCoordX,
+    typename TGetVertexCoordY,
+    typename TVertexAllocator,
+    typename TEdgeAllocator>
+CDT_EXPORT DuplicatesInfo RemoveNearDuplicatesAndRemapEdges(
+    std::vector<TVertex, TVertexAllocator>& vertices,
+    std::vector<Edge, TEdgeAllocator>& edges,
+    T epsilon,
+    TGetVertexCoordX getX,
+    TGetVertexCoordY getY);
+
+/**
+ * Weld points closer than epsilon, remove welded points and remap edges
+ * (see @ref RemoveNearDuplicatesAndRemapEdges)
+ *
+ * @tparam T type of vertex coordinates (e.g., float, double)
+ * @param[in, out] vertices vertices to remove welded points from
+ * @param[in, out] edges collection of edges to remap
+ * @param epsilon points within this distance are welded
+ */
+template <typename T>
+CDT_EXPORT DuplicatesInfo RemoveNearDuplicatesAndRemapEdges(
+    std::vector<V2d<T> >& vertices,
+    std::vector<Edge>& edges,
+    T epsilon);
+
 /**
  * Calculate depth of each triangle in constraint triangulation.
  *
@@ -424,7 +979,7 @@ CDT_EXPORT std::vector<LayerDepth> CalculateTriangleDepths(
     const TriInd seed,
     const TriangleVec& triangles,
     const EdgeUSet& fixedEdges,
-    const unordered_map<Edge, BoundaryOverlapCount>& overlapCount);
+    const EdgeOverlapCountUMap& overlapCount);
 
 /**
  * Depth-peel a layer in triangulation, used when calculating triangle depths
@@ -475,7 +1030,7 @@ unordered_map<TriInd, LayerDepth> PeelLayer(
     std::stack<TriInd> seeds,
     const TriangleVec& triangles,
     const EdgeUSet& fixedEdges,
-    const unordered_map<Edge, BoundaryOverlapCount>& overlapCount,
+    const EdgeOverlapCountUMap& overlapCount,
     const LayerDepth layerDepth,
     std::vector<LayerDepth>& triDepths);
 
@@ -487,6 +1042,49 @@ unordered_map<TriInd, LayerDepth> PeelLayer(
  */
 CDT_EXPORT EdgeUSet extractEdgesFromTriangles(const TriangleVec& triangles);
 
+/**
+ * Map each split constraint edge to the fixed edges (pieces) it was split into
+ *
+ * @param pieceToOriginals map from pieces to the original constraint edges
+ * they represent (see @ref Triangulation::pieceToOriginals)
+ * @return map from original constraint edges to their pieces. Only has
+ * entries for constraint edges that were split.
+ */
+CDT_EXPORT EdgeToEdgesUMap
+EdgeToPiecesMapping(const EdgeToEdgesUMap& pieceToOriginals);
+
+/**
+ * Get chains of vertices along split constraint edges
+ *
+ * Chains are found from pieces' connectivity (no geometric computations).
+ * Each chain starts at edge.v1() and ends at edge.v2() and consecutive
+ * vertices of a chain are the pieces of the edge.
+ * @note chain is cut short if a piece was erased (e.g., with outer triangles)
+ *
+ * @param edgeToPieces map from original constraint edges to their pieces
+ * (see @ref EdgeToPiecesMapping)
+ * @return map from original constraint edges to ordered vertices on them
+ */
+CDT_EXPORT EdgeToVerticesUMap
+EdgeToSplitVertices(const EdgeToEdgesUMap& edgeToPieces);
+
+/**
+ * Extract all edges of triangulation's triangles without hashing
+ *
+ * Each edge is taken once: from the triangle with smaller index or from the
+ * only triangle if edge is on the boundary. Edges are ordered by the index
+ * of the triangle they are taken from.
+ * @note requires valid triangle neighbors (e.g., triangles of
+ * @ref Triangulation), use @ref extractEdgesFromTriangles otherwise
+ * @note runs in parallel when OpenMP is enabled (see @ref
+ * minParallelLoopSize)
+ *
+ * @param triangles triangles used to extract edges
+ * @return vector of all edges of triangulation
+ */
+CDT_EXPORT std::vector<Edge>
+extractEdgeVectorFromTriangles(const TriangleVec& triangles);
+
 } // namespace CDT
 
 //*****************************************************************************
@@ -504,12 +1102,7 @@ struct hash<CDT::V2d<T> >
 {
     size_t operator()(const CDT::V2d<T>& xy) const
     {
-#ifdef CDT_CXX11_IS_SUPPORTED
-        typedef std::hash<T> Hasher;
-#else
-        typedef boost::hash<T> Hasher;
-#endif
-        return Hasher()(xy.x) ^ Hasher()(xy.y);
+        return CDT::V2dHash<T>()(xy);
     }
 };
 } // namespace std
@@ -533,6 +1126,121 @@ void random_shuffle(RandomIt first, RandomIt last)
     }
 }
 
+/// Sort range: chunks are sorted in parallel and merged when OpenMP is enabled
+template <class RandomIt, class Compare>
+void parallelSort(RandomIt first, RandomIt last, Compare comp)
+{
+#ifdef _OPENMP
+    const std::ptrdiff_t n = last - first;
+    const std::ptrdiff_t nChunks = omp_get_max_threads();
+    if(n >= minParallelLoopSize && nChunks > 1)
+    {
+        std::vector<std::ptrdiff_t> bounds(nChunks + 1);
+        for(std::ptrdiff_t i = 0; i <= nChunks; ++i)
+            bounds[i] = n * i / nChunks;
+#pragma omp parallel for
+        for(std::ptrdiff_t i = 0; i < nChunks; ++i)
+            std::sort(first + bounds[i], first + bounds[i + 1], comp);
+        for(std::ptrdiff_t width = 1; width < nChunks; width *= 2)
+        {
+#pragma omp parallel for
+            for(std::ptrdiff_t i = 0; i < nChunks - width; i += 2 * width)
+            {
+                const std::ptrdiff_t iLast = std::min(i + 2 * width, nChunks);
+                std::inplace_merge(
+                    first + bounds[i],
+                    first + bounds[i + width],
+                    first + bounds[iLast],
+                    comp);
+            }
+        }
+        return;
+    }
+#endif
+    std::sort(first, last, comp);
+}
+
+/// Hasher of integer grid cell coordinates
+struct GridCellHash
+{
+    /// Hash operator
+    std::size_t operator()(const std::pair<long long, long long>& c) const
+    {
+        return mixHash(mixHash(c.first) + c.second);
+    }
+};
+
+/// If edge connects a vertex to itself
+inline bool isZeroLengthEdge(const Edge& e)
+{
+    return e.v1() == e.v2();
+}
+
+/// Point with its index in the input
+template <typename T>
+struct IndexedPoint
+{
+    V2d<T> pos;        ///< position
+    std::size_t index; ///< index in the input
+};
+
+/**
+ * Throw if a range does not have three non-collinear points needed for
+ * creating the first triangle with ghost vertex.
+ * Called before any vertex is added so that the triangulation is unchanged.
+ */
+template <
+    typename T,
+    typename TVertexIter,
+    typename TGetVertexCoordX,
+    typename TGetVertexCoordY>
+void checkGhostSeeds(
+    const TVertexIter first,
+    const TVertexIter last,
+    TGetVertexCoordX getX,
+    TGetVertexCoordY getY)
+{
+    TVertexIter it = first;
+    if(it != last)
+    {
+        const V2d<T> v1 = V2d<T>::make(getX(*it), getY(*it));
+        while(it != last && V2d<T>::make(getX(*it), getY(*it)) == v1)
+            ++it;
+        if(it != last)
+        {
+            const V2d<T> v2 = V2d<T>::make(getX(*it), getY(*it));
+            for(; it != last; ++it)
+            {
+                const V2d<T> v = V2d<T>::make(getX(*it), getY(*it));
+                if(locatePointLine(v, v1, v2) != PtLineLocation::OnLine)
+                    return;
+            }
+        }
+    }
+    throw std::runtime_error("Ghost vertex needs at least three "
+                             "non-collinear vertices to start with");
+}
+
+/// Order points by x-coordinate, then by y-coordinate
+template <typename T>
+bool lessPoint(const V2d<T>& a, const V2d<T>& b)
+{
+    if(a.x != b.x)
+        return a.x < b.x;
+    return a.y < b.y;
+}
+
+/// Order points by coordinates, equal points by index
+template <typename T>
+bool lessPointThenIndex(const IndexedPoint<T>& a, const IndexedPoint<T>& b)
+{
+    if(a.pos.x != b.pos.x)
+        return a.pos.x < b.pos.x;
+    if(a.pos.y != b.pos.y)
+        return a.pos.y < b.pos.y;
+    return a.index < b.index;
+}
+
 } // namespace detail
 
 //-----------------------
@@ -550,34 +1258,163 @@ void Triangulation<T, TNearPointLocator>::insertVertices(
     TGetVertexCoordY getY)
 {
     detail::randGenerator.seed(9001); // ensure deterministic behavior
-    if(vertices.empty())
+    if(m_superGeomType == SuperGeometryType::GhostVertex && triangles.empty())
+        detail::checkGhostSeeds<T>(first, last, getX, getY);
+    prepareToInsertVertices(first, last, getX, getY);
+
+    const std::size_t nExistingVerts = vertices.size();
+    const std::size_t nVerts = nExistingVerts + std::distance(first, last);
+    // keep geometric growth when vertices are inserted in small batches
+    if(nVerts > vertices.capacity())
+        vertices.reserve(std::max(nVerts, 2 * nExistingVerts));
+    for(TVertexIter it = first; it != last; ++it)
+        addNewVertex(V2d<T>::make(getX(*it), getY(*it)), TriIndVec());
+
+    std::vector<VertInd> ii(std::distance(first, last));
+    typedef std::vector<VertInd>::iterator Iter;
+    VertInd value = nExistingVerts;
+    for(Iter it = ii.begin(); it != ii.end(); ++it, ++value)
+        *it = value;
+    if(m_vertexInsertionOrder == VertexInsertionOrder::Randomized)
+        detail::random_shuffle(ii.begin(), ii.end());
+    std::vector<VertInd>::const_iterator it = ii.begin();
+    if(m_superGeomType == SuperGeometryType::GhostVertex && triangles.empty())
+        it = addGhostTriangles(ii);
+    for(; it != ii.end(); ++it)
+        insertVertex(*it);
+    eraseDummies(); // left from replacing super-triangle
+}
+
+/// Add super-triangle or switch to ghost vertex if vertices are outside of it
+template <typename T, typename TNearPointLocator>
+template <
+    typename TVertexIter,
+    typename TGetVertexCoordX,
+    typename TGetVertexCoordY>
+void Triangulation<T, TNearPointLocator>::prepareToInsertVertices(
+    const TVertexIter first,
+    const TVertexIter last,
+    TGetVertexCoordX getX,
+    TGetVertexCoordY getY)
+{
+    if(vertices.empty() && m_superGeomType != SuperGeometryType::GhostVertex)
     {
         addSuperTriangle(envelopBox<T>(first, last, getX, getY));
     }
+    else if(hasSuperTriangle())
+    {
+        // vertices outside of super-triangle: continue with ghost vertex
+        const V2d<T> s1 = vertices[0], s2 = vertices[1], s3 = vertices[2];
+        for(TVertexIter it = first; it != last; ++it)
+        {
+            const V2d<T> v = V2d<T>::make(getX(*it), getY(*it));
+            if(locatePointTriangle(v, s1, s2, s3) != PtTriLocation::Inside)
+            {
+                replaceSuperTriangleWithGhostVertex();
+                break;
+            }
+        }
+    }
+}
 
-    const std::size_t nExistingVerts = vertices.size();
+template <typename T, typename TNearPointLocator>
+template <
+    typename TVertexIter,
+    typename TGetVertexCoordX,
+    typename TGetVertexCoordY>
+std::vector<VertInd> Triangulation<T, TNearPointLocator>::insertPolyline(
+    const TVertexIter first,
+    const TVertexIter last,
+    TGetVertexCoordX getX,
+    TGetVertexCoordY getY,
+    const T weldEpsilon)
+{
+    return insertChain(first, last, getX, getY, false, weldEpsilon);
+}
 
-    vertices.reserve(nExistingVerts + std::distance(first, last));
-    for(TVertexIter it = first; it != last; ++it)
-        addNewVertex(V2d<T>::make(getX(*it), getY(*it)), TriIndVec());
+template <typename T, typename TNearPointLocator>
+template <
+    typename TVertexIter,
+    typename TGetVertexCoordX,
+    typename TGetVertexCoordY>
+std::vector<VertInd> Triangulation<T, TNearPointLocator>::insertRing(
+    const TVertexIter first,
+    const TVertexIter last,
+    TGetVertexCoordX getX,
+    TGetVertexCoordY getY,
+    const T weldEpsilon)
+{
+    return insertChain(first, last, getX, getY, true, weldEpsilon);
+}
 
-    switch(m_vertexInsertionOrder)
+/*!
+ * Insert chain of points one by one continuing each search from the previous
+ * vertex, then insert fixed edges of the chain.
+ * Ghost vertex needs a triangle to start with: the first three
+ * non-collinear points are added up-front and then welded by the search.
+ */
+template <typename T, typename TNearPointLocator>
+template <
+    typename TVertexIter,
+    typename TGetVertexCoordX,
+    typename TGetVertexCoordY>
+std::vector<VertInd> Triangulation<T, TNearPointLocator>::insertChain(
+    const TVertexIter first,
+    const TVertexIter last,
+    TGetVertexCoordX getX,
+    TGetVertexCoordY getY,
+    const bool isClosed,
+    const T weldEpsilon)
+{
+    std::vector<VertInd> chain;
+    if(first == last)
+        return chain;
+    detail::randGenerator.seed(9001); // ensure deterministic behavior
+    const bool isFirstGhostTriangle =
+        m_superGeomType == SuperGeometryType::GhostVertex && triangles.empty();
+    if(isFirstGhostTriangle)
+        detail::checkGhostSeeds<T>(first, last, getX, getY);
+    prepareToInsertVertices(first, last, getX, getY);
+    if(isFirstGhostTriangle)
     {
-    case VertexInsertionOrder::AsProvided:
+        std::vector<VertInd> iVerts;
+        const V2d<T> v1 = V2d<T>::make(getX(*first), getY(*first));
+        addNewVertex(v1, TriIndVec());
+        iVerts.push_back(VertInd(vertices.size() - 1));
         for(TVertexIter it = first; it != last; ++it)
-            insertVertex(VertInd(nExistingVerts + std::distance(first, it)));
-        break;
-    case VertexInsertionOrder::Randomized:
-        std::vector<VertInd> ii(std::distance(first, last));
-        typedef std::vector<VertInd>::iterator Iter;
-        VertInd value = nExistingVerts;
-        for(Iter it = ii.begin(); it != ii.end(); ++it, ++value)
-            *it = value;
-        detail::random_shuffle(ii.begin(),ii.end());
-        for(Iter it = ii.begin(); it != ii.end(); ++it)
-            insertVertex(*it);
-        break;
+        {
+            const V2d<T> v = V2d<T>::make(getX(*it), getY(*it));
+            if(v == v1 || (iVerts.size() == 2 &&
+                           locatePointLine(v, v1, vertices[iVerts[1]]) ==
+                               PtLineLocation::OnLine))
+            {
+                continue;
+            }
+            addNewVertex(v, TriIndVec());
+            iVerts.push_back(VertInd(vertices.size() - 1));
+            if(iVerts.size() == 3)
+                break;
+        }
+        addGhostTriangles(iVerts);
     }
+    chain.reserve(std::distance(first, last));
+    VertInd iPrev = noVertex;
+    for(TVertexIter it = first; it != last; ++it)
+    {
+        const V2d<T> v = V2d<T>::make(getX(*it), getY(*it));
+        iPrev = insertChainVertex(v, iPrev, weldEpsilon);
+        chain.push_back(VertInd(iPrev - m_nTargetVerts));
+    }
+    eraseDummies(); // left from replacing super-triangle
+    std::vector<Edge> edges;
+    edges.reserve(chain.size());
+    for(std::size_t i = 1; i < chain.size(); ++i)
+        if(chain[i - 1] != chain[i])
+            edges.push_back(Edge(chain[i - 1], chain[i]));
+    if(isClosed && chain.back() != chain.front())
+        edges.push_back(Edge(chain.back(), chain.front()));
+    insertEdges(edges);
+    return chain;
 }
 
 template <typename T, typename TNearPointLocator>
@@ -591,12 +1428,36 @@ void Triangulation<T, TNearPointLocator>::insertEdges(
     TGetEdgeVertexStart getStart,
     TGetEdgeVertexEnd getEnd)
 {
+    // triangles could change since the last call
+    m_edgeInsertionContext.vertexStars.clear();
+#ifdef _OPENMP
+    if(m_constraintInsertionMethod ==
+           ConstraintInsertionMethod::Retriangulation &&
+       m_intersectingEdgesStrategy == IntersectingConstraintEdges::Ignore &&
+       std::distance(first, last) >= minParallelLoopSize &&
+       omp_get_max_threads() > 1)
+    {
+        std::vector<Edge> edges;
+        edges.reserve(std::distance(first, last));
+        for(; first != last; ++first)
+            edges.push_back(Edge(
+                VertInd(getStart(*first) + m_nTargetVerts),
+                VertInd(getEnd(*first) + m_nTargetVerts)));
+        insertEdgesInParallel(edges);
+        eraseDummies();
+        return;
+    }
+#endif
     for(; first != last; ++first)
     {
         // +3 to account for super-triangle vertices
-        insertEdge(Edge(
+        const Edge edge(
             VertInd(getStart(*first) + m_nTargetVerts),
-            VertInd(getEnd(*first) + m_nTargetVerts)));
+            VertInd(getEnd(*first) + m_nTargetVerts));
+        if(m_constraintInsertionMethod == ConstraintInsertionMethod::EdgeFlips)
+            insertEdgeFlipping(edge, edge);
+        else
+            insertEdge(edge, edge, m_edgeInsertionContext);
     }
     eraseDummies();
 }
@@ -615,9 +1476,10 @@ DuplicatesInfo FindDuplicates(
     TGetVertexCoordX getX,
     TGetVertexCoordY getY)
 {
-    typedef unordered_map<V2d<T>, std::size_t> PosToIndex;
-    PosToIndex uniqueVerts;
     const std::size_t verticesSize = std::distance(first, last);
+    typedef FlatHashMap<V2d<T>, std::size_t, V2dHash<T> > PosToIndex;
+    PosToIndex uniqueVerts;
+    uniqueVerts.reserve(verticesSize);
     DuplicatesInfo di = {
         std::vector<std::size_t>(verticesSize), std::vector<std::size_t>()};
     for(std::size_t iIn = 0, iOut = iIn; iIn < verticesSize; ++iIn, ++first)
@@ -637,6 +1499,51 @@ DuplicatesInfo FindDuplicates(
     return di;
 }
 
+template <
+    typename T,
+    typename TVertexIter,
+    typename TGetVertexCoordX,
+    typename TGetVertexCoordY>
+DuplicatesInfo FindDuplicatesBySorting(
+    TVertexIter first,
+    TVertexIter last,
+    TGetVertexCoordX getX,
+    TGetVertexCoordY getY)
+{
+    typedef detail::IndexedPoint<T> IndexedPoint;
+    const std::size_t verticesSize = std::distance(first, last);
+    std::vector<IndexedPoint> sorted(verticesSize);
+    for(std::size_t i = 0; i < verticesSize; ++i, ++first)
+    {
+        sorted[i].pos = V2d<T>::make(getX(*first), getY(*first));
+        sorted[i].index = i;
+    }
+    detail::parallelSort(
+        sorted.begin(), sorted.end(), detail::lessPointThenIndex<T>);
+    // equal points are sorted by index: first of them is the first occurrence
+    std::vector<std::size_t> firstOccurrence(verticesSize);
+    std::size_t iFirst = 0;
+    for(std::size_t i = 0; i < verticesSize; ++i)
+    {
+        if(i == 0 || !(sorted[i].pos == sorted[i - 1].pos))
+            iFirst = sorted[i].index;
+        firstOccurrence[sorted[i].index] = iFirst;
+    }
+    DuplicatesInfo di = {
+        std::vector<std::size_t>(verticesSize), std::vector<std::size_t>()};
+    for(std::size_t iIn = 0, iOut = 0; iIn < verticesSize; ++iIn)
+    {
+        if(firstOccurrence[iIn] == iIn)
+        {
+            di.mapping[iIn] = iOut++;
+            continue;
+        }
+        di.mapping[iIn] = di.mapping[firstOccurrence[iIn]];
+        di.duplicates.push_back(iIn);
+    }
+    return di;
+}
+
 template <typename TVertex, typename TAllocator>
 void RemoveDuplicates(
     std::vector<TVertex, TAllocator>& vertices,
@@ -671,6 +1578,109 @@ DuplicatesInfo RemoveDuplicatesAndRemapEdges(
     return di;
 }
 
+template <
+    typename T,
+    typename TVertexIter,
+    typename TGetVertexCoordX,
+    typename TGetVertexCoordY>
+DuplicatesInfo FindNearDuplicates(
+    TVertexIter first,
+    TVertexIter last,
+    const T epsilon,
+    TGetVertexCoordX getX,
+    TGetVertexCoordY getY)
+{
+    if(!(epsilon > T(0)))
+        return FindDuplicates<T>(first, last, getX, getY);
+    typedef std::pair<long long, long long> Cell;
+    typedef FlatHashMap<Cell, std::size_t, detail::GridCellHash> CellToPoint;
+    const std::size_t noPoint = std::numeric_limits<std::size_t>::max();
+    const std::size_t verticesSize = std::distance(first, last);
+    // kept points: each grid cell has a list of points threaded through 'next'
+    CellToPoint cellHeads;
+    std::vector<V2d<T> > kept;
+    std::vector<std::size_t> next;
+    cellHeads.reserve(verticesSize);
+    kept.reserve(verticesSize);
+    next.reserve(verticesSize);
+    const T epsilonSq = epsilon * epsilon;
+    const T cellSize = 2 * epsilon;
+    DuplicatesInfo di = {
+        std::vector<std::size_t>(verticesSize), std::vector<std::size_t>()};
+    for(std::size_t iIn = 0; iIn < verticesSize; ++iIn, ++first)
+    {
+        const V2d<T> pos = V2d<T>::make(getX(*first), getY(*first));
+        // cells are 2*epsilon wide: points within epsilon are in 2x2 cells
+        const T cx = pos.x / cellSize;
+        const T cy = pos.y / cellSize;
+        const Cell cell(
+            static_cast<long long>(std::floor(cx)),
+            static_cast<long long>(std::floor(cy)));
+        const long long nx = cx - T(cell.first) < T(0.5) ? -1 : 1;
+        const long long ny = cy - T(cell.second) < T(0.5) ? -1 : 1;
+        // find nearest kept point within epsilon in neighboring cells
+        std::size_t iNearest = noPoint;
+        T minDistSq = epsilonSq;
+        for(long long dy = 0; dy != 2 * ny; dy += ny)
+        {
+            for(long long dx = 0; dx != 2 * nx; dx += nx)
+            {
+                const typename CellToPoint::const_iterator it =
+                    cellHeads.find(Cell(cell.first + dx, cell.second + dy));
+                if(it == cellHeads.end())
+                    continue;
+                for(std::size_t i = it->second; i != noPoint; i = next[i])
+                {
+                    const T distSq = distanceSquared(pos, kept[i]);
+                    if(distSq < minDistSq ||
+                       (distSq == minDistSq && i < iNearest))
+                    {
+                        minDistSq = distSq;
+                        iNearest = i;
+                    }
+                }
+            }
+        }
+        if(iNearest != noPoint)
+        {
+            di.mapping[iIn] = iNearest;
+            di.duplicates.push_back(iIn);
+            continue;
+        }
+        di.mapping[iIn] = kept.size();
+        std::size_t& head =
+            cellHeads.insert(std::make_pair(cell, noPoint)).first->second;
+        next.push_back(head);
+        head = kept.size();
+        kept.push_back(pos);
+    }
+    return di;
+}
+
+template <
+    typename T,
+    typename TVertex,
+    typename TGetVertexCoordX,
+    typename TGetVertexCoordY,
+    typename TVertexAllocator,
+    typename TEdgeAllocator>
+DuplicatesInfo RemoveNearDuplicatesAndRemapEdges(
+    std::vector<TVertex, TVertexAllocator>& vertices,
+    std::vector<Edge, TEdgeAllocator>& edges,
+    const T epsilon,
+    TGetVertexCoordX getX,
+    TGetVertexCoordY getY)
+{
+    const DuplicatesInfo di = FindNearDuplicates<T>(
+        vertices.begin(), vertices.end(), epsilon, getX, getY);
+    RemoveDuplicates(vertices, di.duplicates);
+    RemapEdges(edges, di.mapping);
+    edges.erase(
+        std::remove_if(edges.begin(), edges.end(), detail::isZeroLengthEdge),
+        edges.end());
+    return di;
+}
+
 } // namespace CDT
 
 #ifndef CDT_USE_AS_COMPILED_LIBRARY
@@ -30,13 +30,283 @@ array<T, 3> arr3(const T& v0, const T& v1, const T& v2)
     return out;
 }
 
+/// Smallest vertex degree for which vertex star is ordered and binary-searched
+const static std::size_t minSearchedStarSize(16);
+
+/// Index of vertex in triangle or 3 if there is no such vertex or triangle
+CDT_INLINE_IF_HEADER_ONLY Index
+findVertexInd(const TriangleVec& triangles, const TriInd iT, const VertInd iV)
+{
+    if(iT >= triangles.size())
+        return Index(3);
+    const VerticesArr3& vv = triangles[iT].vertices;
+    Index i(0);
+    while(i < Index(3) && vv[i] != iV)
+        ++i;
+    return i;
+}
+
+/// Compare postponed fixed edges by the order of edges they belong to
+CDT_INLINE_IF_HEADER_ONLY bool isFirstLess(
+    const std::pair<std::size_t, Edge>& lhs,
+    const std::pair<std::size_t, Edge>& rhs)
+{
+    return lhs.first < rhs.first;
+}
+
+/// Add edge to the list if it is not in the list yet
+CDT_INLINE_IF_HEADER_ONLY void
+insertUnique(std::vector<Edge>& edges, const Edge& edge)
+{
+    if(std::find(edges.begin(), edges.end(), edge) == edges.end())
+        edges.push_back(edge);
+}
+
+/**
+ * Neighbor across triangle's edge or no-neighbor if the triangle has no such
+ * edge. Reads only the neighbor at the edge: other neighbors can be changed
+ * concurrently.
+ */
+CDT_INLINE_IF_HEADER_ONLY TriInd
+edgeNeighbor(const Triangle& t, const VertInd iV1, const VertInd iV2)
+{
+    const VerticesArr3& vv = t.vertices;
+    for(Index i(0); i < Index(3); ++i)
+    {
+        const VertInd iVnext = vv[ccw(i)];
+        if((vv[i] == iV1 && iVnext == iV2) || (vv[i] == iV2 && iVnext == iV1))
+            return t.neighbors[i];
+    }
+    return noNeighbor;
+}
+
+/**
+ * Check if direction from @p a to @p p is in the second half-turn
+ * [180, 360) degrees counter-clockwise from the direction from @p a to @p r
+ */
+template <typename T>
+bool isInSecondHalfTurn(const V2d<T>& p, const V2d<T>& a, const V2d<T>& r)
+{
+    const PtLineLocation::Enum loc = locatePointLine(p, a, r);
+    if(loc != PtLineLocation::OnLine)
+        return loc == PtLineLocation::Right;
+    return (p.x - a.x) * (r.x - a.x) + (p.y - a.y) * (r.y - a.y) < T(0);
+}
+
+/**
+ * Fixed-edge mask of a triangle: i-th edge (shared with i-th neighbor) is
+ * represented by two bits, (fixedEdgeBit << i) is set if the edge is fixed,
+ * (overlapEdgeBit << i) is set if boundaries overlap at the edge
+ */
+const static unsigned char fixedEdgeBit(1);
+const static unsigned char overlapEdgeBit(8); ///< @see fixedEdgeBit
+
+/// Flags of triangle's i-th edge moved to the position of 0-th edge
+CDT_INLINE_IF_HEADER_ONLY unsigned char
+edgeFlags(const unsigned char mask, const Index i)
+{
+    return (mask >> i) & (fixedEdgeBit | overlapEdgeBit);
+}
+
+/**
+ * Fixed-edge mask of each triangle: see @ref fixedEdgeBit and
+ * @ref overlapEdgeBit
+ * @param overlapCount boundary overlaps at fixed edges or NULL if not used
+ */
+CDT_INLINE_IF_HEADER_ONLY std::vector<unsigned char> fixedEdgeMasks(
+    const TriangleVec& triangles,
+    const EdgeUSet& fixedEdges,
+    const EdgeOverlapCountUMap* overlapCount)
+{
+    const std::ptrdiff_t nTris = triangles.size();
+    std::vector<unsigned char> masks(nTris, 0);
+    if(fixedEdges.empty())
+        return masks;
+    // only edges between two vertices of fixed edges need to be looked up
+    std::vector<bool> isFixedEdgeVertex;
+    typedef EdgeUSet::const_iterator EdgeCit;
+    for(EdgeCit it = fixedEdges.begin(); it != fixedEdges.end(); ++it)
+    {
+        if(it->v2() >= isFixedEdgeVertex.size())
+            isFixedEdgeVertex.resize(it->v2() + 1, false);
+        isFixedEdgeVertex[it->v1()] = true;
+        isFixedEdgeVertex[it->v2()] = true;
+    }
+    const VertInd nVerts(isFixedEdgeVertex.size());
+#ifdef _OPENMP
+#pragma omp parallel for if(nTris >= minParallelLoopSize)
+#endif
+    for(std::ptrdiff_t iT = 0; iT < nTris; ++iT)
+    {
+        const Triangle& t = triangles[iT];
+        unsigned char mask = 0;
+        for(Index i(0); i < Index(3); ++i)
+        {
+            const VertInd v1 = t.vertices[i];
+            const VertInd v2 = t.vertices[ccw(i)];
+            if(v1 >= nVerts || v2 >= nVerts || !isFixedEdgeVertex[v1] ||
+               !isFixedEdgeVertex[v2])
+            {
+                continue;
+            }
+            const Edge edge(v1, v2);
+            if(!fixedEdges.count(edge))
+                continue;
+            mask |= fixedEdgeBit << i;
+            if(overlapCount && overlapCount->count(edge))
+                mask |= overlapEdgeBit << i;
+        }
+        masks[iT] = mask;
+    }
+    return masks;
+}
+
+/**
+ * Calculate triangle depths by peeling layers. Each region (connected
+ * component bounded by fixed edges) of a layer is traversed breadth-first
+ * from its first seed with a flat frontier; each frontier step is processed
+ * in parallel for large frontiers.
+ * @param fixedEdgeMasks fixed-edge mask of each triangle
+ * @param overlapCount boundary overlaps at edges with @ref overlapEdgeBit
+ * @param[out] regions region of each triangle and depth of each region or
+ * NULL if not used
+ */
+CDT_INLINE_IF_HEADER_ONLY std::vector<LayerDepth> calculateTriangleDepths(
+    const TriInd seed,
+    const TriangleVec& triangles,
+    const std::vector<unsigned char>& fixedEdgeMasks,
+    const EdgeOverlapCountUMap& overlapCount,
+    TriangleRegions* regions)
+{
+    const LayerDepth noDepth = std::numeric_limits<LayerDepth>::max();
+    std::vector<LayerDepth> triDepths(triangles.size(), noDepth);
+    if(regions)
+    {
+        regions->regions.assign(triangles.size(), noNeighbor);
+        regions->regionDepths.clear();
+    }
+    std::vector<TriIndVec> seedsByDepth(1, TriIndVec(1, seed));
+    // triangles behind boundaries of current layer and their depths
+    TriIndVec behind;
+    std::vector<LayerDepth> behindDepths;
+    std::vector<LayerDepth> minBehindDepth(triangles.size(), noDepth);
+    TriIndVec layerSeeds;
+    TriIndVec frontier;
+    TriIndVec nextFrontier;
+    TriIndVec adjacent;
+    for(std::size_t iLayer = 0; iLayer < seedsByDepth.size(); ++iLayer)
+    {
+        const LayerDepth layerDepth(iLayer);
+        layerSeeds.clear();
+        layerSeeds.swap(seedsByDepth[iLayer]);
+        typedef TriIndVec::const_iterator TriIndCit;
+        behind.clear();
+        behindDepths.clear();
+        for(TriIndCit it = layerSeeds.begin(); it != layerSeeds.end(); ++it)
+        {
+            // seed was peeled from another seed or through a shallower boundary
+            if(triDepths[*it] <= layerDepth)
+                continue;
+            triDepths[*it] = layerDepth;
+            const TriInd iRegion = regions ? regions->regionDepths.size() : 0;
+            if(regions)
+            {
+                regions->regions[*it] = iRegion;
+                regions->regionDepths.push_back(layerDepth);
+            }
+            frontier.assign(1, *it);
+            while(!frontier.empty())
+            {
+                // find not yet peeled neighbors of the frontier triangles
+                const std::ptrdiff_t nFront = frontier.size();
+                adjacent.assign(3 * nFront, noNeighbor);
+#ifdef _OPENMP
+#pragma omp parallel for if(nFront >= minParallelLoopSize)
+#endif
+                for(std::ptrdiff_t j = 0; j < nFront; ++j)
+                {
+                    const Triangle& t = triangles[frontier[j]];
+                    for(Index i(0); i < Index(3); ++i)
+                    {
+                        const TriInd iN = t.neighbors[i];
+                        if(iN != noNeighbor && triDepths[iN] > layerDepth)
+                            adjacent[3 * j + i] = iN;
+                    }
+                }
+                // advance the frontier, stopping at fixed edges
+                nextFrontier.clear();
+                for(std::ptrdiff_t j = 0; j < nFront; ++j)
+                {
+                    const Triangle& t = triangles[frontier[j]];
+                    for(Index i(0); i < Index(3); ++i)
+                    {
+                        const TriInd iN = adjacent[3 * j + i];
+                        if(iN == noNeighbor)
+                            continue;
+                        const unsigned char flags =
+                            edgeFlags(fixedEdgeMasks[frontier[j]], i);
+                        if(flags & fixedEdgeBit)
+                        {
+                            LayerDepth depth = layerDepth + 1;
+                            if(flags & overlapEdgeBit)
+                            {
+                                const Edge edge(
+                                    t.vertices[i], t.vertices[ccw(i)]);
+                                typedef EdgeOverlapCountUMap::const_iterator
+                                    OverlapCit;
+                                const OverlapCit cit = overlapCount.find(edge);
+                                if(cit != overlapCount.end())
+                                    depth += cit->second;
+                            }
+                            behind.push_back(iN);
+                            behindDepths.push_back(depth);
+                            continue;
+                        }
+                        if(triDepths[iN] <= layerDepth)
+                            continue;
+                        triDepths[iN] = layerDepth;
+                        if(regions)
+                            regions->regions[iN] = iRegion;
+                        nextFrontier.push_back(iN);
+                    }
+                }
+                frontier.swap(nextFrontier);
+            }
+        }
+        // triangles behind boundary that are not in this layer seed deeper
+        // layers; if reached through several boundaries the shallowest wins
+        for(std::size_t i = 0; i < behind.size(); ++i)
+        {
+            if(triDepths[behind[i]] != layerDepth)
+            {
+                LayerDepth& minDepth = minBehindDepth[behind[i]];
+                minDepth = std::min(minDepth, behindDepths[i]);
+            }
+        }
+        for(TriIndCit it = behind.begin(); it != behind.end(); ++it)
+        {
+            LayerDepth& minDepth = minBehindDepth[*it];
+            if(minDepth == noDepth)
+                continue;
+            if(minDepth >= seedsByDepth.size())
+                seedsByDepth.resize(minDepth + 1);
+            seedsByDepth[minDepth].push_back(*it);
+            minDepth = noDepth;
+        }
+    }
+    return triDepths;
+}
+
 } // namespace detail
 
 template <typename T, typename TNearPointLocator>
 Triangulation<T, TNearPointLocator>::Triangulation()
     : m_nTargetVerts(0)
     , m_superGeomType(SuperGeometryType::SuperTriangle)
+    , m_minVertex(noVertex)
     , m_vertexInsertionOrder(VertexInsertionOrder::Randomized)
+    , m_constraintInsertionMethod(ConstraintInsertionMethod::Retriangulation)
+    , m_intersectingEdgesStrategy(IntersectingConstraintEdges::Ignore)
 {}
 
 template <typename T, typename TNearPointLocator>
@@ -44,17 +314,68 @@ Triangulation<T, TNearPointLocator>::Triangulation(
     const VertexInsertionOrder::Enum vertexInsertionOrder)
     : m_nTargetVerts(0)
     , m_superGeomType(SuperGeometryType::SuperTriangle)
+    , m_minVertex(noVertex)
     , m_vertexInsertionOrder(vertexInsertionOrder)
+    , m_constraintInsertionMethod(ConstraintInsertionMethod::Retriangulation)
+    , m_intersectingEdgesStrategy(IntersectingConstraintEdges::Ignore)
 {}
 
 template <typename T, typename TNearPointLocator>
 Triangulation<T, TNearPointLocator>::Triangulation(
     VertexInsertionOrder::Enum vertexInsertionOrder,
     const TNearPointLocator& nearPtLocator)
-    : m_nTargetVerts(0)
-    , m_nearPtLocator(nearPtLocator)
+    : m_nearPtLocator(nearPtLocator)
+    , m_nTargetVerts(0)
     , m_superGeomType(SuperGeometryType::SuperTriangle)
+    , m_minVertex(noVertex)
+    , m_vertexInsertionOrder(vertexInsertionOrder)
+    , m_constraintInsertionMethod(ConstraintInsertionMethod::Retriangulation)
+    , m_intersectingEdgesStrategy(IntersectingConstraintEdges::Ignore)
+{}
+
+template <typename T, typename TNearPointLocator>
+Triangulation<T, TNearPointLocator>::Triangulation(
+    VertexInsertionOrder::Enum vertexInsertionOrder,
+    const TNearPointLocator& nearPtLocator,
+    const SuperGeometryType::Enum superGeomType)
+    : m_nearPtLocator(nearPtLocator)
+    , m_nTargetVerts(0)
+    , m_superGeomType(superGeomType)
+    , m_minVertex(noVertex)
+    , m_vertexInsertionOrder(vertexInsertionOrder)
+    , m_constraintInsertionMethod(ConstraintInsertionMethod::Retriangulation)
+    , m_intersectingEdgesStrategy(IntersectingConstraintEdges::Ignore)
+{}
+
+template <typename T, typename TNearPointLocator>
+Triangulation<T, TNearPointLocator>::Triangulation(
+    VertexInsertionOrder::Enum vertexInsertionOrder,
+    const TNearPointLocator& nearPtLocator,
+    const SuperGeometryType::Enum superGeomType,
+    const ConstraintInsertionMethod::Enum constraintInsertionMethod)
+    : m_nearPtLocator(nearPtLocator)
+    , m_nTargetVerts(0)
+    , m_superGeomType(superGeomType)
+    , m_minVertex(noVertex)
+    , m_vertexInsertionOrder(vertexInsertionOrder)
+    , m_constraintInsertionMethod(constraintInsertionMethod)
+    , m_intersectingEdgesStrategy(IntersectingConstraintEdges::Ignore)
+{}
+
+template <typename T, typename TNearPointLocator>
+Triangulation<T, TNearPointLocator>::Triangulation(
+    VertexInsertionOrder::Enum vertexInsertionOrder,
+    const TNearPointLocator& nearPtLocator,
+    const SuperGeometryType::Enum superGeomType,
+    const ConstraintInsertionMethod::Enum constraintInsertionMethod,
+    const IntersectingConstraintEdges::Enum intersectingEdgesStrategy)
+    : m_nearPtLocator(nearPtLocator)
+    , m_nTargetVerts(0)
+    , m_superGeomType(superGeomType)
+    , m_minVertex(noVertex)
     , m_vertexInsertionOrder(vertexInsertionOrder)
+    , m_constraintInsertionMethod(constraintInsertionMethod)
+    , m_intersectingEdgesStrategy(intersectingEdgesStrategy)
 {}
 
 template <typename T, typename TNearPointLocator>
@@ -73,32 +394,48 @@ void Triangulation<T, TNearPointLocator>::eraseDummies()
 {
     if(m_dummyTris.empty())
         return;
-    const TriIndUSet dummySet(m_dummyTris.begin(), m_dummyTris.end());
-    TriIndUMap triIndMap;
-    triIndMap[noNeighbor] = noNeighbor;
-    for(TriInd iT(0), iTnew(0); iT < TriInd(triangles.size()); ++iT)
+    // mark dummies, then enumerate remaining triangles (prefix sum)
+    std::vector<TriInd> triIndMap(triangles.size(), TriInd(0));
+    typedef std::vector<TriInd>::const_iterator TriIndCit;
+    for(TriIndCit it = m_dummyTris.begin(); it != m_dummyTris.end(); ++it)
+        triIndMap[*it] = noNeighbor;
+    TriInd iTnew(0);
+    for(TriInd iT(0); iT < TriInd(triangles.size()); ++iT)
     {
-        if(dummySet.count(iT))
+        if(triIndMap[iT] == noNeighbor)
             continue;
         triIndMap[iT] = iTnew;
         triangles[iTnew] = triangles[iT];
+        m_fixedEdgeMasks[iTnew] = m_fixedEdgeMasks[iT];
         iTnew++;
     }
-    triangles.erase(triangles.end() - dummySet.size(), triangles.end());
+    triangles.erase(triangles.begin() + iTnew, triangles.end());
+    m_fixedEdgeMasks.resize(iTnew);
 
     // remap adjacent triangle indices for vertices
-    typedef typename VerticesTriangles::iterator VertTrisIt;
-    for(VertTrisIt vTris = vertTris.begin(); vTris != vertTris.end(); ++vTris)
+    const std::ptrdiff_t nVerts = vertTris.size();
+#ifdef _OPENMP
+#pragma omp parallel for if(nVerts >= minParallelLoopSize)
+#endif
+    for(std::ptrdiff_t iV = 0; iV < nVerts; ++iV)
     {
-        for(TriIndVec::iterator iT = vTris->begin(); iT != vTris->end(); ++iT)
+        TriIndVec& vTris = vertTris[iV];
+        for(TriIndVec::iterator iT = vTris.begin(); iT != vTris.end(); ++iT)
             *iT = triIndMap[*iT];
     }
     // remap neighbor indices for triangles
-    for(TriangleVec::iterator t = triangles.begin(); t != triangles.end(); ++t)
+    const std::ptrdiff_t nTris = triangles.size();
+#ifdef _OPENMP
+#pragma omp parallel for if(nTris >= minParallelLoopSize)
+#endif
+    for(std::ptrdiff_t iT = 0; iT < nTris; ++iT)
     {
-        NeighborsArr3& nn = t->neighbors;
+        NeighborsArr3& nn = triangles[iT].neighbors;
         for(NeighborsArr3::iterator iN = nn.begin(); iN != nn.end(); ++iN)
-            *iN = triIndMap[*iN];
+        {
+            if(*iN != noNeighbor)
+                *iN = triIndMap[*iN];
+        }
     }
     // clear dummy triangles
     m_dummyTris = std::vector<TriInd>();
@@ -107,7 +444,14 @@ void Triangulation<T, TNearPointLocator>::eraseDummies()
 template <typename T, typename TNearPointLocator>
 void Triangulation<T, TNearPointLocator>::eraseSuperTriangleVertices()
 {
-    if(m_superGeomType != SuperGeometryType::SuperTriangle)
+    if(m_superGeomType == SuperGeometryType::GhostVertex)
+    {
+        m_superGeomType = SuperGeometryType::Custom;
+        // ghost vertex has no index: shift only if it replaced super-triangle
+        if(m_nTargetVerts != 3)
+            return;
+    }
+    else if(m_superGeomType != SuperGeometryType::SuperTriangle)
         return;
     for(TriangleVec::iterator t = triangles.begin(); t != triangles.end(); ++t)
         for(Index i(0); i < Index(3); ++i)
@@ -115,6 +459,7 @@ void Triangulation<T, TNearPointLocator>::eraseSuperTriangleVertices()
 
     EdgeUSet updatedFixedEdges;
     typedef CDT::EdgeUSet::const_iterator EdgeCit;
+    typedef std::vector<Edge>::const_iterator EdgeVecCit;
     for(EdgeCit e = fixedEdges.begin(); e != fixedEdges.end(); ++e)
     {
         updatedFixedEdges.insert(
@@ -122,13 +467,54 @@ void Triangulation<T, TNearPointLocator>::eraseSuperTriangleVertices()
     }
     fixedEdges = updatedFixedEdges;
 
+    EdgeOverlapCountUMap updatedOverlapCount;
+    typedef EdgeOverlapCountUMap::const_iterator OverlapCit;
+    for(OverlapCit it = overlapCount.begin(); it != overlapCount.end(); ++it)
+    {
+        const Edge& e = it->first;
+        updatedOverlapCount.insert(std::make_pair(
+            Edge(VertInd(e.v1() - 3), VertInd(e.v2() - 3)), it->second));
+    }
+    overlapCount = updatedOverlapCount;
+
+    EdgeToEdgesUMap updatedPieceToOriginals;
+    typedef EdgeToEdgesUMap::const_iterator PiecesCit;
+    for(PiecesCit it = pieceToOriginals.begin(); it != pieceToOriginals.end();
+        ++it)
+    {
+        std::vector<Edge> originals;
+        originals.reserve(it->second.size());
+        for(EdgeVecCit e = it->second.begin(); e != it->second.end(); ++e)
+            originals.push_back(
+                Edge(VertInd(e->v1() - 3), VertInd(e->v2() - 3)));
+        const Edge& e = it->first;
+        updatedPieceToOriginals[Edge(
+            VertInd(e.v1() - 3), VertInd(e.v2() - 3))].swap(originals);
+    }
+    pieceToOriginals.swap(updatedPieceToOriginals);
+
     vertices = std::vector<V2d<T> >(vertices.begin() + 3, vertices.end());
     vertTris = VerticesTriangles(vertTris.begin() + 3, vertTris.end());
+    // super-triangle is gone: vertices 0-2 are now regular vertices and
+    // later insertions must neither treat them as super-triangle vertices in
+    // flip rules nor offset input indices by 3
+    m_superGeomType = SuperGeometryType::Custom;
+    m_nTargetVerts = 0;
 }
 
 template <typename T, typename TNearPointLocator>
 void Triangulation<T, TNearPointLocator>::eraseSuperTriangle()
 {
+    if(m_superGeomType == SuperGeometryType::GhostVertex)
+    {
+        const std::vector<TriInd> ghosts = ghostTriangles();
+        typedef std::vector<TriInd>::const_iterator TriIndCit;
+        for(TriIndCit it = ghosts.begin(); it != ghosts.end(); ++it)
+            makeDummy(*it);
+        eraseDummies();
+        eraseSuperTriangleVertices();
+        return;
+    }
     if(m_superGeomType != SuperGeometryType::SuperTriangle)
         return;
     // make dummy triangles adjacent to super-triangle's vertices
@@ -146,8 +532,10 @@ template <typename T, typename TNearPointLocator>
 void Triangulation<T, TNearPointLocator>::eraseOuterTriangles()
 {
     // make dummy triangles adjacent to super-triangle's vertices
-    const std::stack<TriInd> seed(std::deque<TriInd>(1, vertTris[0].front()));
-    const TriIndUSet toErase = growToBoundary(seed);
+    const std::vector<TriInd> toErase = growToBoundary(
+        m_superGeomType == SuperGeometryType::GhostVertex
+            ? ghostTriangles()
+            : std::vector<TriInd>(1, vertTris[0].front()));
     eraseTrianglesAtIndices(toErase.begin(), toErase.end());
     eraseSuperTriangleVertices();
 }
@@ -155,8 +543,8 @@ void Triangulation<T, TNearPointLocator>::eraseOuterTriangles()
 template <typename T, typename TNearPointLocator>
 void Triangulation<T, TNearPointLocator>::eraseOuterTrianglesAndHoles()
 {
-    const std::vector<LayerDepth> triDepths = CalculateTriangleDepths(
-        vertTris[0].front(), triangles, fixedEdges, overlapCount);
+    const std::vector<LayerDepth> triDepths = detail::calculateTriangleDepths(
+        outerSeedTriangle(), triangles, m_fixedEdgeMasks, overlapCount, NULL);
 
     TriIndVec toErase;
     toErase.reserve(triangles.size());
@@ -170,6 +558,31 @@ void Triangulation<T, TNearPointLocator>::eraseOuterTrianglesAndHoles()
     eraseSuperTriangleVertices();
 }
 
+template <typename T, typename TNearPointLocator>
+TriangleRegions
+Triangulation<T, TNearPointLocator>::calculateTriangleRegions() const
+{
+    TriangleRegions regions;
+    if(triangles.empty())
+        return regions;
+    regions.depths = detail::calculateTriangleDepths(
+        outerSeedTriangle(),
+        triangles,
+        m_fixedEdgeMasks,
+        overlapCount,
+        &regions);
+    return regions;
+}
+
+/// Triangle to start depth peeling from: outside of all boundaries
+template <typename T, typename TNearPointLocator>
+TriInd Triangulation<T, TNearPointLocator>::outerSeedTriangle() const
+{
+    return m_superGeomType == SuperGeometryType::GhostVertex
+               ? ghostTriangles().front()
+               : vertTris[0].front();
+}
+
 template <typename T, typename TNearPointLocator>
 template <typename TriIndexIter>
 void Triangulation<T, TNearPointLocator>::eraseTrianglesAtIndices(
@@ -181,6 +594,62 @@ void Triangulation<T, TNearPointLocator>::eraseTrianglesAtIndices(
     eraseDummies();
 }
 
+template <typename T, typename TNearPointLocator>
+bool Triangulation<T, TNearPointLocator>::hasSuperTriangle() const
+{
+    return m_superGeomType == SuperGeometryType::SuperTriangle &&
+           !vertices.empty();
+}
+
+template <typename T, typename TNearPointLocator>
+std::vector<VertInd> Triangulation<T, TNearPointLocator>::convexHull() const
+{
+    std::vector<VertInd> hull;
+    if(m_superGeomType != SuperGeometryType::GhostVertex || triangles.empty())
+        return hull;
+    const std::vector<TriInd> ghosts = ghostTriangles();
+    hull.reserve(ghosts.size());
+    typedef std::vector<TriInd>::const_iterator TriIndCit;
+    for(TriIndCit it = ghosts.begin(); it != ghosts.end(); ++it)
+    {
+        const Triangle& t = triangles[*it];
+        hull.push_back(t.vertices[ccw(vertexInd(t, ghostVertex))]);
+    }
+    return hull;
+}
+
+/*!
+ * Ghost triangles in counter-clockwise order around the convex hull
+ * Ghost triangle (v1, v2, ghost) is outside of the hull edge (v2, v1): the
+ * next ghost triangle counter-clockwise is its neighbor across (ghost, v1)
+ */
+template <typename T, typename TNearPointLocator>
+std::vector<TriInd> Triangulation<T, TNearPointLocator>::ghostTriangles() const
+{
+    // the lowest vertex is on the hull and has ghost triangles
+    const TriIndVec& vTris = vertTris[m_minVertex];
+    TriIndVec::const_iterator itStart = vTris.begin();
+    while(!isGhost(*itStart))
+        ++itStart;
+    std::vector<TriInd> ghosts;
+    TriInd iT = *itStart;
+    do
+    {
+        ghosts.push_back(iT);
+        const Triangle& t = triangles[iT];
+        iT = t.neighbors[vertexInd(t, ghostVertex)];
+    } while(iT != *itStart);
+    return ghosts;
+}
+
+template <typename T, typename TNearPointLocator>
+bool Triangulation<T, TNearPointLocator>::isGhost(const TriInd iT) const
+{
+    const VerticesArr3& vv = triangles[iT].vertices;
+    return vv[0] == ghostVertex || vv[1] == ghostVertex ||
+           vv[2] == ghostVertex;
+}
+
 template <typename T, typename TNearPointLocator>
 void Triangulation<T, TNearPointLocator>::initializedWithCustomSuperGeometry()
 {
@@ -188,29 +657,36 @@ void Triangulation<T, TNearPointLocator>::initializedWithCustomSuperGeometry()
     {
         m_nearPtLocator.addPoint(VertInd(i), vertices);
     }
+    m_fixedEdgeMasks =
+        detail::fixedEdgeMasks(triangles, fixedEdges, &overlapCount);
     m_nTargetVerts = vertices.size();
     m_superGeomType = SuperGeometryType::Custom;
 }
 
 template <typename T, typename TNearPointLocator>
-TriIndUSet Triangulation<T, TNearPointLocator>::growToBoundary(
-    std::stack<TriInd> seeds) const
+std::vector<TriInd> Triangulation<T, TNearPointLocator>::growToBoundary(
+    std::vector<TriInd> seeds) const
 {
-    TriIndUSet traversed;
+    std::vector<bool> isTraversed(triangles.size(), false);
+    typedef std::vector<TriInd>::const_iterator TriIndCit;
+    for(TriIndCit it = seeds.begin(); it != seeds.end(); ++it)
+        isTraversed[*it] = true;
+    std::vector<TriInd> traversed;
     while(!seeds.empty())
     {
-        const TriInd iT = seeds.top();
-        seeds.pop();
-        traversed.insert(iT);
+        const TriInd iT = seeds.back();
+        seeds.pop_back();
+        traversed.push_back(iT);
         const Triangle& t = triangles[iT];
         for(Index i(0); i < Index(3); ++i)
         {
-            const Edge opEdge(t.vertices[ccw(i)], t.vertices[cw(i)]);
-            if(fixedEdges.count(opEdge))
+            const TriInd iN = t.neighbors[i];
+            if(iN == noNeighbor || isTraversed[iN])
                 continue;
-            const TriInd iN = t.neighbors[opoNbr(i)];
-            if(iN != noNeighbor && traversed.count(iN) == 0)
-                seeds.push(iN);
+            if(m_fixedEdgeMasks[iT] & (detail::fixedEdgeBit << i))
+                continue;
+            isTraversed[iN] = true;
+            seeds.push_back(iN);
         }
     }
     return traversed;
@@ -218,6 +694,14 @@ TriIndUSet Triangulation<T, TNearPointLocator>::growToBoundary(
 
 template <typename T, typename TNearPointLocator>
 void Triangulation<T, TNearPointLocator>::makeDummy(const TriInd iT)
+{
+    makeDummy(iT, m_dummyTris);
+}
+
+template <typename T, typename TNearPointLocator>
+void Triangulation<T, TNearPointLocator>::makeDummy(
+    const TriInd iT,
+    std::vector<TriInd>& dummyTris)
 {
     const Triangle& t = triangles[iT];
 
@@ -229,7 +713,7 @@ void Triangulation<T, TNearPointLocator>::makeDummy(const TriInd iT)
     for(NCit iTn = t.neighbors.begin(); iTn != t.neighbors.end(); ++iTn)
         changeNeighbor(*iTn, iT, noNeighbor);
 
-    m_dummyTris.push_back(iT);
+    dummyTris.push_back(iT);
 }
 
 template <typename T, typename TNearPointLocator>
@@ -238,27 +722,39 @@ TriInd Triangulation<T, TNearPointLocator>::addTriangle(const Triangle& t)
     if(m_dummyTris.empty())
     {
         triangles.push_back(t);
+        m_fixedEdgeMasks.push_back(0);
         return TriInd(triangles.size() - 1);
     }
     const TriInd nxtDummy = m_dummyTris.back();
     m_dummyTris.pop_back();
     triangles[nxtDummy] = t;
+    m_fixedEdgeMasks[nxtDummy] = 0;
     return nxtDummy;
 }
 
 template <typename T, typename TNearPointLocator>
 TriInd Triangulation<T, TNearPointLocator>::addTriangle()
 {
-    if(m_dummyTris.empty())
+    return addTriangle(m_dummyTris);
+}
+
+/// Add triangle re-using the last dummy triangle if there is one
+template <typename T, typename TNearPointLocator>
+TriInd Triangulation<T, TNearPointLocator>::addTriangle(
+    std::vector<TriInd>& dummyTris)
+{
+    if(dummyTris.empty())
     {
         const Triangle dummy = {
             {noVertex, noVertex, noVertex},
             {noNeighbor, noNeighbor, noNeighbor}};
         triangles.push_back(dummy);
+        m_fixedEdgeMasks.push_back(0);
         return TriInd(triangles.size() - 1);
     }
-    const TriInd nxtDummy = m_dummyTris.back();
-    m_dummyTris.pop_back();
+    const TriInd nxtDummy = dummyTris.back();
+    dummyTris.pop_back();
+    m_fixedEdgeMasks[nxtDummy] = 0;
     return nxtDummy;
 }
 
@@ -272,36 +768,147 @@ void Triangulation<T, TNearPointLocator>::insertEdges(
 template <typename T, typename TNearPointLocator>
 void Triangulation<T, TNearPointLocator>::fixEdge(const Edge& edge)
 {
+    unsigned char flags = detail::fixedEdgeBit;
     if(!fixedEdges.insert(edge).second)
     {
         ++overlapCount[edge]; // if edge is already fixed bump a counter
+        flags |= detail::overlapEdgeBit;
+    }
+    // mark the edge in both adjacent triangles
+    const TriIndVec& tris = vertTris[edge.v1()];
+    typedef TriIndVec::const_iterator TriIndCit;
+    for(TriIndCit it = tris.begin(); it != tris.end(); ++it)
+    {
+        const Triangle& t = triangles[*it];
+        const VerticesArr3& vv = t.vertices;
+        if(std::find(vv.begin(), vv.end(), edge.v2()) == vv.end())
+            continue;
+        const Index i = opposedTriangleInd(t, edge.v1(), edge.v2());
+        m_fixedEdgeMasks[*it] |= flags << i;
+        const TriInd iN = t.neighbors[i];
+        if(iN != noNeighbor)
+            m_fixedEdgeMasks[iN] |= flags << neighborInd(triangles[iN], *it);
+        return;
+    }
+}
+
+/// Fix edge that is a piece of original constraint edge
+template <typename T, typename TNearPointLocator>
+void Triangulation<T, TNearPointLocator>::fixEdge(
+    const Edge& edge,
+    const Edge& originalEdge)
+{
+    typedef EdgeToEdgesUMap::iterator PiecesIt;
+    if(edge != originalEdge)
+    {
+        const std::pair<PiecesIt, bool> res = pieceToOriginals.insert(
+            std::make_pair(edge, std::vector<Edge>()));
+        std::vector<Edge>& originals = res.first->second;
+        if(res.second && fixedEdges.count(edge)) // fixed as an original edge
+            originals.push_back(edge);
+        detail::insertUnique(originals, originalEdge);
+    }
+    else if(!pieceToOriginals.empty())
+    {
+        // original edge coincides with a piece of another edge
+        const PiecesIt it = pieceToOriginals.find(edge);
+        if(it != pieceToOriginals.end())
+            detail::insertUnique(it->second, edge);
     }
+    fixEdge(edge);
 }
 
+/// Fix edge or postpone fixing it when edges are inserted in parallel
 template <typename T, typename TNearPointLocator>
-void Triangulation<T, TNearPointLocator>::insertEdge(Edge edge)
+void Triangulation<T, TNearPointLocator>::fixEdge(
+    const Edge& edge,
+    const Edge& originalEdge,
+    detail::EdgeInsertionContext& ctx)
+{
+    if(ctx.isParallel) // original edge is known from edge's order
+        ctx.fixedEdges.push_back(std::make_pair(ctx.iEdge, edge));
+    else
+        fixEdge(edge, originalEdge);
+}
+
+template <typename T, typename TNearPointLocator>
+void Triangulation<T, TNearPointLocator>::splitFixedEdge(
+    const Edge& edge,
+    const VertInd iSplitVert)
+{
+    fixedEdges.erase(edge);
+    const Edge half1(edge.v1(), iSplitVert);
+    const Edge half2(iSplitVert, edge.v2());
+    fixedEdges.insert(half1);
+    fixedEdges.insert(half2);
+    // halves represent the same original edges as the split edge
+    std::vector<Edge> originals(1, edge);
+    typedef EdgeToEdgesUMap::iterator PiecesIt;
+    const PiecesIt itPieces = pieceToOriginals.find(edge);
+    if(itPieces != pieceToOriginals.end())
+    {
+        originals.swap(itPieces->second);
+        pieceToOriginals.erase(itPieces);
+    }
+    pieceToOriginals[half1] = originals;
+    pieceToOriginals[half2].swap(originals);
+    typedef EdgeOverlapCountUMap::iterator OverlapIt;
+    const OverlapIt it = overlapCount.find(edge);
+    if(it == overlapCount.end())
+        return;
+    const BoundaryOverlapCount count = it->second;
+    overlapCount.erase(it);
+    overlapCount[half1] = count;
+    overlapCount[half2] = count;
+}
+
+/// Flags of an edge (see detail::edgeFlags) looked up in a triangle sharing
+/// it or in fixed edges if there is no such triangle
+template <typename T, typename TNearPointLocator>
+unsigned char Triangulation<T, TNearPointLocator>::edgeFlags(
+    const TriInd iT,
+    const VertInd iV1,
+    const VertInd iV2) const
+{
+    if(iT != noNeighbor)
+    {
+        const Index i = opposedTriangleInd(triangles[iT], iV1, iV2);
+        return detail::edgeFlags(m_fixedEdgeMasks[iT], i);
+    }
+    const Edge edge(iV1, iV2);
+    if(!fixedEdges.count(edge))
+        return 0;
+    return overlapCount.count(edge)
+               ? detail::fixedEdgeBit | detail::overlapEdgeBit
+               : detail::fixedEdgeBit;
+}
+
+template <typename T, typename TNearPointLocator>
+void Triangulation<T, TNearPointLocator>::insertEdge(
+    Edge edge,
+    const Edge originalEdge,
+    detail::EdgeInsertionContext& ctx)
 {
     const VertInd iA = edge.v1();
     VertInd iB = edge.v2();
     if(iA == iB) // edge connects a vertex to itself
         return;
-    const TriIndVec& aTris = vertTris[iA];
-    const TriIndVec& bTris = vertTris[iB];
     const V2d<T>& a = vertices[iA];
     const V2d<T>& b = vertices[iB];
-    if(verticesShareEdge(aTris, bTris))
+    if(hasEdge(iA, iB))
     {
-        fixEdge(Edge(iA, iB));
+        fixEdge(Edge(iA, iB), originalEdge, ctx);
         return;
     }
     TriInd iT;
     VertInd iVleft, iVright;
-    tie(iT, iVleft, iVright) = intersectedTriangle(iA, aTris, a, b);
+    tie(iT, iVleft, iVright) = intersectedTriangle(iA, a, b, ctx.vertexStars);
+    snapToEdge(iT, iVleft, iVright, a, b);
     // if one of the triangle vertices is on the edge, move edge start
     if(iT == noNeighbor)
     {
-        fixEdge(Edge(iA, iVleft));
-        return insertEdge(Edge(iVleft, iB));
+        fixEdge(Edge(iA, iVleft), originalEdge, ctx);
+        return insertEdge(Edge(iVleft, iB), originalEdge, ctx);
     }
     std::vector<TriInd> intersected(1, iT);
     std::vector<VertInd> ptsLeft(1, iVleft);
@@ -312,15 +919,21 @@ void Triangulation<T, TNearPointLocator>::insertEdge(Edge edge)
     while(std::find(tverts.begin(), tverts.end(), iB) == tverts.end())
     {
         const TriInd iTopo = opposedTriangle(t, iV);
+        if(isCrossingFixedEdge(iT, iV))
+        {
+            // nothing was changed yet: insert edge halves from scratch
+            const VertInd iVnew = insertIntersectionVertex(iA, iB, iT, iTopo);
+            insertEdge(Edge(iA, iVnew), originalEdge, ctx);
+            return insertEdge(Edge(iVnew, iB), originalEdge, ctx);
+        }
         const Triangle& tOpo = triangles[iTopo];
         const VertInd iVopo = opposedVertex(tOpo, iT);
-        const V2d<T> vOpo = vertices[iVopo];
 
         intersected.push_back(iTopo);
         iT = iTopo;
         t = triangles[iT];
 
-        const PtLineLocation::Enum loc = locatePointLine(vOpo, a, b);
+        const PtLineLocation::Enum loc = locateEdgeVertex(iVopo, a, b);
         if(loc == PtLineLocation::Left)
         {
             ptsLeft.push_back(iVopo);
@@ -336,20 +949,513 @@ void Triangulation<T, TNearPointLocator>::insertEdge(Edge edge)
         else // encountered point on the edge
             iB = iVopo;
     }
-    // Remove intersected triangles
+    // Remove intersected triangles: re-used by pseudo-polygon triangulations
+    std::vector<TriInd>& dummyTris =
+        ctx.isParallel ? ctx.dummyTris : m_dummyTris;
     typedef std::vector<TriInd>::const_iterator TriIndCit;
     for(TriIndCit it = intersected.begin(); it != intersected.end(); ++it)
-        makeDummy(*it);
+        makeDummy(*it, dummyTris);
     // Triangulate pseudo-polygons on both sides
-    const TriInd iTleft = triangulatePseudopolygon(iA, iB, ptsLeft);
+    const TriInd iTleft = triangulatePseudopolygon(iA, iB, ptsLeft, ctx);
     std::reverse(ptsRight.begin(), ptsRight.end());
-    const TriInd iTright = triangulatePseudopolygon(iB, iA, ptsRight);
-    changeNeighbor(iTleft, noNeighbor, iTright);
-    changeNeighbor(iTright, noNeighbor, iTleft);
+    const TriInd iTright = triangulatePseudopolygon(iB, iA, ptsRight, ctx);
+    // link by the edge: other border edges can have no neighbor too
+    if(iTleft != noNeighbor)
+        changeNeighbor(iTleft, iA, iB, iTright);
+    if(iTright != noNeighbor)
+        changeNeighbor(iTright, iA, iB, iTleft);
+    // add fixed edge
+    fixEdge(Edge(iA, iB), originalEdge, ctx);
+    if(iB != edge.v2()) // encountered point on the edge
+        return insertEdge(Edge(iB, edge.v2()), originalEdge, ctx);
+}
+
+/*!
+ * Insert constraint edge by flipping the edges it intersects (Sloan):
+ *  - intersected edge is flipped if its quadrilateral is strictly convex,
+ *    otherwise it is postponed until its neighbors are flipped
+ *  - flipped edge that still intersects the constraint is flipped again
+ *  - new edges are flipped until they are Delaunay
+ */
+template <typename T, typename TNearPointLocator>
+void Triangulation<T, TNearPointLocator>::insertEdgeFlipping(
+    Edge edge,
+    const Edge originalEdge)
+{
+    const VertInd iA = edge.v1();
+    VertInd iB = edge.v2();
+    if(iA == iB) // edge connects a vertex to itself
+        return;
+    const V2d<T>& a = vertices[iA];
+    const V2d<T>& b = vertices[iB];
+    if(hasEdge(iA, iB))
+    {
+        fixEdge(Edge(iA, iB), originalEdge);
+        return;
+    }
+    TriInd iT;
+    VertInd iVleft, iVright;
+    tie(iT, iVleft, iVright) = intersectedTriangle(
+        iA, a, b, m_edgeInsertionContext.vertexStars);
+    snapToEdge(iT, iVleft, iVright, a, b);
+    // if one of the triangle vertices is on the edge, move edge start
+    if(iT == noNeighbor)
+    {
+        fixEdge(Edge(iA, iVleft), originalEdge);
+        return insertEdgeFlipping(Edge(iVleft, iB), originalEdge);
+    }
+    std::vector<Edge>& intersected = m_edgeFlipBuffers.intersected;
+    std::vector<Edge>& postponed = m_edgeFlipBuffers.postponed;
+    std::vector<Edge>& newEdges = m_edgeFlipBuffers.newEdges;
+    intersected.clear();
+    newEdges.clear();
+    VertInd iV = iA;
+    Triangle t = triangles[iT];
+    const VerticesArr3& tverts = t.vertices;
+    while(std::find(tverts.begin(), tverts.end(), iB) == tverts.end())
+    {
+        const TriInd iTopo = opposedTriangle(t, iV);
+        if(isCrossingFixedEdge(iT, iV))
+        {
+            // nothing was flipped yet: insert edge halves from scratch
+            const VertInd iVnew = insertIntersectionVertex(iA, iB, iT, iTopo);
+            insertEdgeFlipping(Edge(iA, iVnew), originalEdge);
+            return insertEdgeFlipping(Edge(iVnew, iB), originalEdge);
+        }
+        intersected.push_back(Edge(iVleft, iVright));
+        const VertInd iVopo = opposedVertex(triangles[iTopo], iT);
+        iT = iTopo;
+        t = triangles[iT];
+        const PtLineLocation::Enum loc = locateEdgeVertex(iVopo, a, b);
+        if(loc == PtLineLocation::Left)
+        {
+            iV = iVleft;
+            iVleft = iVopo;
+        }
+        else if(loc == PtLineLocation::Right)
+        {
+            iV = iVright;
+            iVright = iVopo;
+        }
+        else // encountered point on the edge
+            iB = iVopo;
+    }
+    // Flip intersected edges in passes
+    typedef std::vector<Edge>::const_iterator EdgeCit;
+    while(!intersected.empty())
+    {
+        for(EdgeCit it = intersected.begin(); it != intersected.end(); ++it)
+        {
+            iT = edgeTriangle(it->v1(), it->v2());
+            const Triangle& tEdge = triangles[iT];
+            const Index i = opposedTriangleInd(tEdge, it->v1(), it->v2());
+            const TriInd iTopo = tEdge.neighbors[i];
+            const VertInd iV1 = tEdge.vertices[cw(i)];
+            const VertInd iV2 = opposedVertex(triangles[iTopo], iT);
+            const V2d<T>& v1 = vertices[iV1];
+            const V2d<T>& v2 = vertices[iV2];
+            const PtLineLocation::Enum loc1 =
+                locatePointLine(vertices[it->v1()], v1, v2);
+            const PtLineLocation::Enum loc2 =
+                locatePointLine(vertices[it->v2()], v1, v2);
+            if(loc1 == loc2 || loc1 == PtLineLocation::OnLine ||
+               loc2 == PtLineLocation::OnLine) // not strictly convex
+            {
+                postponed.push_back(*it);
+                continue;
+            }
+            flipEdge(iT, iTopo);
+            const PtLineLocation::Enum locV1 = locatePointLine(v1, a, b);
+            const PtLineLocation::Enum locV2 = locatePointLine(v2, a, b);
+            if(locV1 != locV2 && locV1 != PtLineLocation::OnLine &&
+               locV2 != PtLineLocation::OnLine)
+            {
+                postponed.push_back(Edge(iV1, iV2));
+            }
+            else
+                newEdges.push_back(Edge(iV1, iV2));
+        }
+        intersected.swap(postponed);
+        postponed.clear();
+    }
     // add fixed edge
-    fixEdge(Edge(iA, iB));
+    fixEdge(Edge(iA, iB), originalEdge);
+    flipEdgesUntilDelaunay(newEdges);
     if(iB != edge.v2()) // encountered point on the edge
-        return insertEdge(Edge(iB, edge.v2()));
+        return insertEdgeFlipping(Edge(iB, edge.v2()), originalEdge);
+}
+
+/// Location of vertex relative to inserted edge: with resolved intersections
+/// vertices within rounding error of the edge are on the edge
+template <typename T, typename TNearPointLocator>
+PtLineLocation::Enum Triangulation<T, TNearPointLocator>::locateEdgeVertex(
+    const VertInd iV,
+    const V2d<T>& a,
+    const V2d<T>& b) const
+{
+    const V2d<T>& v = vertices[iV];
+    const PtLineLocation::Enum loc = locatePointLine(v, a, b);
+    if(m_intersectingEdgesStrategy == IntersectingConstraintEdges::Resolve &&
+       loc != PtLineLocation::OnLine && isWithinRoundingError(v, a, b))
+    {
+        return PtLineLocation::OnLine;
+    }
+    return loc;
+}
+
+/// Treat vertex of the first intersected triangle that is on the edge (see
+/// @ref locateEdgeVertex) same as vertex exactly on the edge: no triangle
+/// and the vertex is returned in @p iVleft
+template <typename T, typename TNearPointLocator>
+void Triangulation<T, TNearPointLocator>::snapToEdge(
+    TriInd& iT,
+    VertInd& iVleft,
+    const VertInd iVright,
+    const V2d<T>& a,
+    const V2d<T>& b) const
+{
+    if(iT == noNeighbor ||
+       m_intersectingEdgesStrategy != IntersectingConstraintEdges::Resolve)
+    {
+        return;
+    }
+    if(locateEdgeVertex(iVleft, a, b) == PtLineLocation::OnLine)
+        iT = noNeighbor;
+    else if(locateEdgeVertex(iVright, a, b) == PtLineLocation::OnLine)
+    {
+        iT = noNeighbor;
+        iVleft = iVright;
+    }
+}
+
+/// If intersecting edges are resolved and inserted edge crosses the fixed
+/// edge of triangle @p iT opposed to its vertex @p iV
+template <typename T, typename TNearPointLocator>
+bool Triangulation<T, TNearPointLocator>::isCrossingFixedEdge(
+    const TriInd iT,
+    const VertInd iV) const
+{
+    if(m_intersectingEdgesStrategy != IntersectingConstraintEdges::Resolve)
+        return false;
+    const Index i = opposedTriangleInd(triangles[iT], iV);
+    return detail::edgeFlags(m_fixedEdgeMasks[iT], i) & detail::fixedEdgeBit;
+}
+
+/*!
+ * Insert vertex where edge (iA, iB) crosses the fixed edge shared by
+ * triangles @p iT and @p iTopo. The vertex is inserted on the fixed edge
+ * which is split in two fixed edges keeping its overlap count.
+ */
+template <typename T, typename TNearPointLocator>
+VertInd Triangulation<T, TNearPointLocator>::insertIntersectionVertex(
+    const VertInd iA,
+    const VertInd iB,
+    const TriInd iT,
+    const TriInd iTopo)
+{
+    const Triangle& t = triangles[iT];
+    const Index i = neighborInd(t, iTopo);
+    const V2d<T> pos = intersectionPosition(
+        vertices[iA],
+        vertices[iB],
+        vertices[t.vertices[i]],
+        vertices[t.vertices[ccw(i)]]);
+    addNewVertex(pos, TriIndVec());
+    const VertInd iVnew(vertices.size() - 1);
+    const array<TriInd, 2> trisAt = {iT, iTopo};
+    insertVertex(iVnew, trisAt);
+    return iVnew;
+}
+
+/*!
+ * Vertices of triangles intersected by the edge (@ref insertEdge removes
+ * them): edge insertion changes only triangles with all vertices in the
+ * corridor and links to them. Does not change the triangulation.
+ */
+template <typename T, typename TNearPointLocator>
+void Triangulation<T, TNearPointLocator>::edgeCorridorVertices(
+    Edge edge,
+    detail::VertexStarCache& stars,
+    std::vector<VertInd>& corridor) const
+{
+    corridor.clear();
+    const VertInd iEnd = edge.v2();
+    const V2d<T>& b = vertices[iEnd];
+    VertInd iA = edge.v1();
+    while(iA != iEnd)
+    {
+        corridor.push_back(iA);
+        if(hasEdge(iA, iEnd))
+            break;
+        const V2d<T>& a = vertices[iA];
+        TriInd iT;
+        VertInd iVleft, iVright;
+        tie(iT, iVleft, iVright) = intersectedTriangle(iA, a, b, stars);
+        if(iT == noNeighbor)
+        {
+            iA = iVleft;
+            continue;
+        }
+        corridor.push_back(iVleft);
+        corridor.push_back(iVright);
+        VertInd iV = iA;
+        VertInd iB = iEnd;
+        while(true)
+        {
+            const Triangle& t = triangles[iT];
+            const VerticesArr3& tverts = t.vertices;
+            if(std::find(tverts.begin(), tverts.end(), iB) != tverts.end())
+                break;
+            const TriInd iTopo = opposedTriangle(t, iV);
+            const VertInd iVopo = opposedVertex(triangles[iTopo], iT);
+            iT = iTopo;
+            const PtLineLocation::Enum loc =
+                locatePointLine(vertices[iVopo], a, b);
+            if(loc == PtLineLocation::Left)
+            {
+                iV = iVleft;
+                iVleft = iVopo;
+            }
+            else if(loc == PtLineLocation::Right)
+            {
+                iV = iVright;
+                iVright = iVopo;
+            }
+            else // encountered point on the edge
+                iB = iVopo;
+            if(iVopo != iB)
+                corridor.push_back(iVopo);
+        }
+        iA = iB;
+    }
+    corridor.push_back(iEnd);
+}
+
+/*!
+ * Insert edges in rounds, in each round:
+ *  - corridors of triangles intersected by the edges are found in parallel
+ *  - in input order edges are picked if their corridors have no vertices
+ *    in common with corridors of already picked edges
+ *  - picked edges are inserted in parallel: each changes only its corridor
+ *  - edges are fixed in input order, remaining edges go to the next round
+ * Remaining edges are inserted sequentially when too few can be picked.
+ * @note triangulation does not depend on the number of threads
+ */
+template <typename T, typename TNearPointLocator>
+void Triangulation<T, TNearPointLocator>::insertEdgesInParallel(
+    std::vector<Edge>& edges)
+{
+#ifdef _OPENMP
+    typedef std::vector<VertInd>::const_iterator VertIndCit;
+    typedef std::vector<std::pair<std::size_t, Edge> >::const_iterator FixCit;
+    std::vector<detail::EdgeInsertionContext> contexts(omp_get_max_threads());
+    for(std::size_t i = 0; i < contexts.size(); ++i)
+        contexts[i].isParallel = true;
+    std::vector<std::vector<VertInd> > corridors;
+    std::vector<std::size_t> vertexRound(vertices.size(), 0);
+    std::vector<std::size_t> picked;
+    std::vector<Edge> remaining;
+    std::vector<std::pair<std::size_t, Edge> > fixed;
+    for(std::size_t round = 1; !edges.empty(); ++round)
+    {
+        const std::ptrdiff_t nEdges = edges.size();
+        corridors.resize(nEdges);
+        // ordered vertex stars could be outdated by the previous round
+        for(std::size_t i = 0; i < contexts.size(); ++i)
+            contexts[i].vertexStars.clear();
+#pragma omp parallel for schedule(dynamic, 256)
+        for(std::ptrdiff_t i = 0; i < nEdges; ++i)
+        {
+            detail::EdgeInsertionContext& ctx = contexts[omp_get_thread_num()];
+            edgeCorridorVertices(edges[i], ctx.vertexStars, corridors[i]);
+        }
+        picked.clear();
+        remaining.clear();
+        for(std::ptrdiff_t i = 0; i < nEdges; ++i)
+        {
+            const std::vector<VertInd>& corridor = corridors[i];
+            bool isFree = true;
+            for(VertIndCit it = corridor.begin(); it != corridor.end(); ++it)
+                if(vertexRound[*it] == round)
+                {
+                    isFree = false;
+                    break;
+                }
+            if(!isFree)
+            {
+                remaining.push_back(edges[i]);
+                continue;
+            }
+            for(VertIndCit it = corridor.begin(); it != corridor.end(); ++it)
+                vertexRound[*it] = round;
+            picked.push_back(i);
+        }
+        if(picked.size() < edges.size() / 8) // not worth another round
+            break;
+        // other threads change triangles in cached stars of corridor vertices
+        for(std::size_t i = 0; i < contexts.size(); ++i)
+            contexts[i].vertexStars.clear();
+        const std::ptrdiff_t nPicked = picked.size();
+#pragma omp parallel for schedule(dynamic, 64)
+        for(std::ptrdiff_t i = 0; i < nPicked; ++i)
+        {
+            detail::EdgeInsertionContext& ctx = contexts[omp_get_thread_num()];
+            ctx.iEdge = i;
+            // same pseudo-polygon triangulations with any number of threads
+            ctx.pseudopoly.randState = i;
+            insertEdge(edges[picked[i]], edges[picked[i]], ctx);
+        }
+        fixed.clear();
+        for(std::size_t i = 0; i < contexts.size(); ++i)
+        {
+            std::vector<std::pair<std::size_t, Edge> >& ctxFixed =
+                contexts[i].fixedEdges;
+            fixed.insert(fixed.end(), ctxFixed.begin(), ctxFixed.end());
+            ctxFixed.clear();
+        }
+        std::stable_sort(fixed.begin(), fixed.end(), detail::isFirstLess);
+        for(FixCit it = fixed.begin(); it != fixed.end(); ++it)
+            fixEdge(it->second, edges[picked[it->first]]);
+        edges.swap(remaining);
+    }
+#endif
+    typedef std::vector<Edge>::const_iterator EdgeCit;
+    for(EdgeCit it = edges.begin(); it != edges.end(); ++it)
+        insertEdge(*it, *it, m_edgeInsertionContext);
+}
+
+/// Triangle containing the edge or no-neighbor if there is no such edge
+template <typename T, typename TNearPointLocator>
+TriInd Triangulation<T, TNearPointLocator>::edgeTriangle(
+    const VertInd iV1,
+    const VertInd iV2) const
+{
+    const TriIndVec& tris = vertTris[iV1];
+    typedef TriIndVec::const_iterator TriIndCit;
+    for(TriIndCit it = tris.begin(); it != tris.end(); ++it)
+    {
+        const VerticesArr3& vv = triangles[*it].vertices;
+        if(std::find(vv.begin(), vv.end(), iV2) != vv.end())
+            return *it;
+    }
+    return noNeighbor;
+}
+
+/// Check if vertices share an edge: scans triangles of the lower-degree vertex
+template <typename T, typename TNearPointLocator>
+bool Triangulation<T, TNearPointLocator>::hasEdge(
+    const VertInd iV1,
+    const VertInd iV2) const
+{
+    return vertTris[iV1].size() <= vertTris[iV2].size()
+               ? edgeTriangle(iV1, iV2) != noNeighbor
+               : edgeTriangle(iV2, iV1) != noNeighbor;
+}
+
+/*!
+ * Triangles around the vertex ordered counter-clockwise by walking across
+ * the edges connected to the vertex.
+ * @returns false and empty @p star if the vertex star is open or contains
+ * ghost triangles, i.e., vertex is on the boundary or on the convex hull
+ */
+template <typename T, typename TNearPointLocator>
+bool Triangulation<T, TNearPointLocator>::orderedVertexStar(
+    const VertInd iV,
+    std::vector<TriInd>& star) const
+{
+    const TriIndVec& vTris = vertTris[iV];
+    star.clear();
+    const TriInd iTstart = vTris.front();
+    TriInd iT = iTstart;
+    do
+    {
+        if(iT == noNeighbor || isGhost(iT) || star.size() == vTris.size())
+        {
+            star.clear();
+            return false;
+        }
+        star.push_back(iT);
+        const Triangle& t = triangles[iT];
+        iT = t.neighbors[cw(vertexInd(t, iV))];
+    } while(iT != iTstart);
+    if(star.size() == vTris.size())
+        return true;
+    star.clear();
+    return false;
+}
+
+/*!
+ * Binary-search triangles around the vertex ordered counter-clockwise for the
+ * triangle intersected by the edge. Ordered triangles can be outdated by edge
+ * insertions: the found triangle is verified.
+ * @param[out] out see @ref intersectedTriangle
+ * @returns false if no valid triangle was found
+ */
+template <typename T, typename TNearPointLocator>
+bool Triangulation<T, TNearPointLocator>::searchVertexStar(
+    const VertInd iA,
+    const V2d<T>& a,
+    const V2d<T>& b,
+    const std::vector<TriInd>& star,
+    tuple<TriInd, VertInd, VertInd>& out) const
+{
+    // Angles are measured counter-clockwise from the direction of the first
+    // triangle's first edge (a, r)
+    Index i = detail::findVertexInd(triangles, star.front(), iA);
+    if(i == Index(3) || isGhost(star.front()))
+        return false;
+    const V2d<T>& r = vertices[triangles[star.front()].vertices[ccw(i)]];
+    const bool isBinSecondHalf = detail::isInSecondHalfTurn(b, a, r);
+    // find the last triangle starting before or at the direction of b
+    std::size_t lo = 0, hi = star.size();
+    while(hi - lo > 1)
+    {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        i = detail::findVertexInd(triangles, star[mid], iA);
+        if(i == Index(3) || isGhost(star[mid]))
+            return false;
+        const V2d<T>& p = vertices[triangles[star[mid]].vertices[ccw(i)]];
+        const bool isPinSecondHalf = detail::isInSecondHalfTurn(p, a, r);
+        const bool isAfter =
+            isBinSecondHalf != isPinSecondHalf
+                ? isBinSecondHalf
+                : locatePointLine(b, a, p) != PtLineLocation::Right;
+        (isAfter ? lo : hi) = mid;
+    }
+    TriInd iT = star[lo];
+    i = detail::findVertexInd(triangles, iT, iA);
+    // edge goes through triangle's vertex: it is left of previous triangle
+    const V2d<T>& pStart = vertices[triangles[iT].vertices[ccw(i)]];
+    if(locatePointLine(pStart, a, b) == PtLineLocation::OnLine)
+    {
+        iT = star[lo == 0 ? star.size() - 1 : lo - 1];
+        i = detail::findVertexInd(triangles, iT, iA);
+        if(i == Index(3) || isGhost(iT))
+            return false;
+    }
+    const Triangle& t = triangles[iT];
+    const VertInd iP1 = t.vertices[cw(i)];
+    const VertInd iP2 = t.vertices[ccw(i)];
+    // removed triangles are not linked by their former neighbors
+    const TriInd iTn1 = t.neighbors[i];
+    const TriInd iTn2 = t.neighbors[cw(i)];
+    if(iTn1 == noNeighbor || iTn2 == noNeighbor ||
+       detail::edgeNeighbor(triangles[iTn1], iA, iP2) != iT ||
+       detail::edgeNeighbor(triangles[iTn2], iA, iP1) != iT)
+    {
+        return false;
+    }
+    const PtLineLocation::Enum locP1 = locatePointLine(vertices[iP1], a, b);
+    const PtLineLocation::Enum locP2 = locatePointLine(vertices[iP2], a, b);
+    if(locP2 != PtLineLocation::Right)
+        return false;
+    if(locP1 == PtLineLocation::OnLine)
+        out = make_tuple(noNeighbor, iP1, iP2);
+    else if(locP1 == PtLineLocation::Left)
+        out = make_tuple(iT, iP1, iP2);
+    else
+        return false;
+    return true;
 }
 
 /*!
@@ -361,65 +1467,447 @@ void Triangulation<T, TNearPointLocator>::insertEdge(Edge edge)
  *  - triangle index is no-neighbor (invalid)
  *  - index of point on the line
  *  - index of point on the right of the line
+ *
+ * Triangles around high-degree vertices are ordered counter-clockwise and
+ * binary-searched: only O(log(degree)) orientation tests are needed.
  */
 template <typename T, typename TNearPointLocator>
 tuple<TriInd, VertInd, VertInd>
 Triangulation<T, TNearPointLocator>::intersectedTriangle(
     const VertInd iA,
-    const std::vector<TriInd>& candidates,
     const V2d<T>& a,
-    const V2d<T>& b) const
+    const V2d<T>& b,
+    detail::VertexStarCache& stars) const
+{
+    const std::vector<TriInd>& candidates = vertTris[iA];
+    // ordered star is re-used by next edges while it leads to valid triangles
+    const std::size_t iSlot = iA % stars.vertices.size();
+    VertInd& iVcached = stars.vertices[iSlot];
+    std::vector<TriInd>& star = stars.stars[iSlot];
+    const bool isCached = iVcached == iA;
+    if(candidates.size() >= detail::minSearchedStarSize &&
+       !(isCached && star.empty())) // open star
+    {
+        tuple<TriInd, VertInd, VertInd> out;
+        if(isCached && searchVertexStar(iA, a, b, star, out))
+            return out;
+        iVcached = iA;
+        if(orderedVertexStar(iA, star) && searchVertexStar(iA, a, b, star, out))
+            return out;
+    }
+    typedef std::vector<TriInd>::const_iterator TriIndCit;
+    for(TriIndCit it = candidates.begin(); it != candidates.end(); ++it)
+    {
+        const TriInd iT = *it;
+        // only vertices are read: neighbors can be concurrently changed by
+        // parallel edge insertion
+        const Triangle& t = triangles[iT];
+        const Index i = vertexInd(t, iA);
+        if(m_superGeomType == SuperGeometryType::GhostVertex && isGhost(iT))
+        {
+            // edge can't cross the hull but can go along a hull edge
+            const VertInd iP = t.vertices[cw(i)] == ghostVertex
+                                   ? t.vertices[ccw(i)]
+                                   : t.vertices[cw(i)];
+            const V2d<T>& p = vertices[iP];
+            if(locatePointLine(p, a, b) == PtLineLocation::OnLine &&
+               (p.x - a.x) * (b.x - a.x) + (p.y - a.y) * (b.y - a.y) > T(0))
+            {
+                return make_tuple(noNeighbor, iP, iP);
+            }
+            continue;
+        }
+        const VertInd iP1 = t.vertices[cw(i)];
+        const VertInd iP2 = t.vertices[ccw(i)];
+        const PtLineLocation::Enum locP1 = locatePointLine(vertices[iP1], a, b);
+        const PtLineLocation::Enum locP2 = locatePointLine(vertices[iP2], a, b);
+        if(locP2 == PtLineLocation::Right)
+        {
+            if(locP1 == PtLineLocation::OnLine)
+                return make_tuple(noNeighbor, iP1, iP2);
+            if(locP1 == PtLineLocation::Left)
+                return make_tuple(iT, iP1, iP2);
+        }
+    }
+    throw std::runtime_error("Could not find vertex triangle intersected by "
+                             "edge. Note: can be caused by duplicate points.");
+}
+
+template <typename T, typename TNearPointLocator>
+void Triangulation<T, TNearPointLocator>::addSuperTriangle(const Box2d<T>& box)
+{
+    m_nTargetVerts = 3;
+    m_superGeomType = SuperGeometryType::SuperTriangle;
+
+    const V2d<T> center = {
+        (box.min.x + box.max.x) / T(2), (box.min.y + box.max.y) / T(2)};
+    const T w = box.max.x - box.min.x;
+    const T h = box.max.y - box.min.y;
+    T r = std::sqrt(w * w + h * h) / T(2); // incircle radius
+    r *= T(1.1);
+    const T R = T(2) * r;                        // excircle radius
+    const T shiftX = R * std::sqrt(T(3)) / T(2); // R * cos(30 deg)
+    const V2d<T> posV1 = {center.x - shiftX, center.y - r};
+    const V2d<T> posV2 = {center.x + shiftX, center.y - r};
+    const V2d<T> posV3 = {center.x, center.y + R};
+    addNewVertex(posV1, TriIndVec(1, TriInd(0)));
+    addNewVertex(posV2, TriIndVec(1, TriInd(0)));
+    addNewVertex(posV3, TriIndVec(1, TriInd(0)));
+    const Triangle superTri = {
+        {VertInd(0), VertInd(1), VertInd(2)},
+        {noNeighbor, noNeighbor, noNeighbor}};
+    addTriangle(superTri);
+
+    m_nearPtLocator.addPoint(VertInd(0), vertices);
+    m_nearPtLocator.addPoint(VertInd(1), vertices);
+    m_nearPtLocator.addPoint(VertInd(2), vertices);
+}
+
+/*!
+ * Start triangulation with ghost vertex: first non-collinear triple of
+ * vertices forms a triangle surrounded by three ghost triangles
+ *          v3
+ *         /  \
+ *   G3   /    \  G2     Gi: ghost triangles, outside of T's edges
+ *       /  T   \
+ *     v1 ------ v2
+ *          G1
+ * Moves the triple to the front, returns where the remaining vertices start
+ */
+template <typename T, typename TNearPointLocator>
+std::vector<VertInd>::const_iterator
+Triangulation<T, TNearPointLocator>::addGhostTriangles(
+    std::vector<VertInd>& iVerts)
+{
+    typedef std::vector<VertInd>::iterator Iter;
+    Iter it2 = iVerts.begin();
+    while(it2 != iVerts.end() && vertices[*it2] == vertices[iVerts.front()])
+        ++it2;
+    Iter it3 = it2;
+    PtLineLocation::Enum loc = PtLineLocation::OnLine;
+    for(; it3 != iVerts.end(); ++it3)
+    {
+        loc = locatePointLine(
+            vertices[*it3], vertices[iVerts.front()], vertices[*it2]);
+        if(loc != PtLineLocation::OnLine)
+            break;
+    }
+    if(it3 == iVerts.end())
+    {
+        throw std::runtime_error("Ghost vertex needs at least three "
+                                 "non-collinear vertices to start with");
+    }
+    std::iter_swap(iVerts.begin() + 1, it2);
+    std::iter_swap(iVerts.begin() + 2, it3);
+    if(loc == PtLineLocation::Right)
+        std::iter_swap(iVerts.begin(), iVerts.begin() + 1);
+    const VertInd v1 = iVerts[0], v2 = iVerts[1], v3 = iVerts[2];
+    const TriInd iT(triangles.size());
+    const TriInd iG1(iT + 1), iG2(iT + 2), iG3(iT + 3);
+    using detail::arr3;
+    addTriangle(Triangle::make(arr3(v1, v2, v3), arr3(iG1, iG2, iG3)));
+    addTriangle(
+        Triangle::make(arr3(v2, v1, ghostVertex), arr3(iT, iG3, iG2)));
+    addTriangle(
+        Triangle::make(arr3(v3, v2, ghostVertex), arr3(iT, iG1, iG3)));
+    addTriangle(
+        Triangle::make(arr3(v1, v3, ghostVertex), arr3(iT, iG2, iG1)));
+    addAdjacentTriangles(v1, iT, iG1, iG3);
+    addAdjacentTriangles(v2, iT, iG1, iG2);
+    addAdjacentTriangles(v3, iT, iG2, iG3);
+    m_nearPtLocator.addPoint(v1, vertices);
+    m_nearPtLocator.addPoint(v2, vertices);
+    m_nearPtLocator.addPoint(v3, vertices);
+    m_minVertex = v1;
+    for(Iter it = iVerts.begin() + 1; it != iVerts.begin() + 3; ++it)
+        if(detail::lessPoint(vertices[*it], vertices[m_minVertex]))
+            m_minVertex = *it;
+    return iVerts.begin() + 3;
+}
+
+namespace detail
+{
+
+/// Index of the edge without super-triangle vertices in a triangle touching
+/// super-triangle or 3 if there is no such edge
+inline Index finiteEdgeInd(const Triangle& t)
+{
+    Index i(0);
+    while(i < Index(3) && (t.vertices[i] < 3 || t.vertices[ccw(i)] < 3))
+        ++i;
+    return i;
+}
+
+} // namespace detail
+
+/*!
+ * Triangles touching super-triangle vertices that have an edge without
+ * super-triangle vertices form the link: a closed chain of edges going
+ * clockwise around the rest of triangles. Returns link triangle following
+ * @p iT: found by rotating clockwise around the end of its edge.
+ */
+template <typename T, typename TNearPointLocator>
+TriInd
+Triangulation<T, TNearPointLocator>::nextLinkTriangle(const TriInd iT) const
+{
+    const Triangle& t = triangles[iT];
+    const Index i = detail::finiteEdgeInd(t);
+    const VertInd iV = t.vertices[ccw(i)];
+    TriInd iTnext = t.neighbors[ccw(i)];
+    while(true)
+    {
+        const Triangle& tNext = triangles[iTnext];
+        const Index j = vertexInd(tNext, iV);
+        if(tNext.vertices[ccw(j)] >= 3)
+            return iTnext;
+        iTnext = tNext.neighbors[j];
+    }
+}
+
+/*!
+ * Fill concave corner of the link at vertex @p iV between link triangles
+ * @p iT1 and @p iT2 with a triangle by flipping the edges connecting @p iV to
+ * super-triangle vertices. Returns the added triangle without super-triangle
+ * vertices.
+ */
+template <typename T, typename TNearPointLocator>
+TriInd Triangulation<T, TNearPointLocator>::fillLinkCorner(
+    const VertInd iV,
+    const TriInd iT1,
+    const TriInd iT2)
+{
+    // fan of triangles around the vertex from one link triangle to other
+    std::vector<TriInd> fan(1, iT1);
+    while(fan.back() != iT2)
+    {
+        const Triangle& t = triangles[fan.back()];
+        fan.push_back(t.neighbors[vertexInd(t, iV)]);
+    }
+    // Corner angle is less than 180 degrees: fan always has an edge that can
+    // be flipped to remove a triangle from the fan
+    const V2d<T>& v = vertices[iV];
+    while(fan.size() > 1)
+    {
+        std::vector<TriInd>::iterator it = fan.begin();
+        for(; it + 1 != fan.end(); ++it)
+        {
+            const Triangle& t = triangles[*it];
+            const Index i = vertexInd(t, iV);
+            const Triangle& tNext = triangles[*(it + 1)];
+            const V2d<T>& vShared = vertices[t.vertices[ccw(i)]];
+            const V2d<T>& v1 = vertices[t.vertices[cw(i)]];
+            const V2d<T>& v2 =
+                vertices[tNext.vertices[ccw(vertexInd(tNext, iV))]];
+            // flip is possible if quadrilateral is strictly convex
+            const PtLineLocation::Enum loc = locatePointLine(v, v1, v2);
+            const PtLineLocation::Enum locShared =
+                locatePointLine(vShared, v1, v2);
+            if(loc != PtLineLocation::OnLine &&
+               locShared != PtLineLocation::OnLine && loc != locShared)
+            {
+                break;
+            }
+        }
+        if(it + 1 == fan.end())
+            throw std::runtime_error("Could not fill convex hull corner");
+        flipEdge(*it, *(it + 1)); // second triangle keeps the vertex
+        fan.erase(it);
+    }
+    return fan.front();
+}
+
+/*!
+ * Replace super-triangle with ghost vertex. Only triangles touching
+ * super-triangle vertices and their neighbors are changed:
+ *  1. concave corners of the link (see nextLinkTriangle) are filled with
+ *     triangles until link goes along the convex hull
+ *  2. link triangles become ghost triangles, other triangles touching
+ *     super-triangle become dummies
+ *  3. Delaunay property is restored for the edges of added triangles
+ * Super-triangle vertices are kept without adjacent triangles so that vertex
+ * indices don't change.
+ */
+template <typename T, typename TNearPointLocator>
+void Triangulation<T, TNearPointLocator>::replaceSuperTriangleWithGhostVertex()
 {
     typedef std::vector<TriInd>::const_iterator TriIndCit;
-    for(TriIndCit it = candidates.begin(); it != candidates.end(); ++it)
+    TriInd iTstart(noNeighbor);
+    for(VertInd iV(0); iV < VertInd(3) && iTstart == noNeighbor; ++iV)
     {
-        const TriInd iT = *it;
-        const Triangle t = triangles[iT];
-        const Index i = vertexInd(t, iA);
-        const VertInd iP1 = t.vertices[cw(i)];
-        const VertInd iP2 = t.vertices[ccw(i)];
-        const PtLineLocation::Enum locP1 = locatePointLine(vertices[iP1], a, b);
-        const PtLineLocation::Enum locP2 = locatePointLine(vertices[iP2], a, b);
-        if(locP2 == PtLineLocation::Right)
+        const TriIndVec& vTris = vertTris[iV];
+        for(TriIndCit it = vTris.begin(); it != vTris.end(); ++it)
         {
-            if(locP1 == PtLineLocation::OnLine)
-                return make_tuple(noNeighbor, iP1, iP2);
-            if(locP1 == PtLineLocation::Left)
-                return make_tuple(iT, iP1, iP2);
+            if(detail::finiteEdgeInd(triangles[*it]) == Index(3))
+                continue;
+            iTstart = *it;
+            break;
         }
     }
-    throw std::runtime_error("Could not find vertex triangle intersected by "
-                             "edge. Note: can be caused by duplicate points.");
+    // link as a cyclic list of link triangles and start vertices of the edges
+    std::vector<TriInd> link;
+    std::vector<VertInd> linkStart;
+    bool isFlat = true; // all link vertices are collinear
+    TriInd iT = iTstart;
+    while(iT != noNeighbor)
+    {
+        const Triangle& t = triangles[iT];
+        const Index i = detail::finiteEdgeInd(t);
+        link.push_back(iT);
+        linkStart.push_back(t.vertices[i]);
+        if(isFlat && linkStart.size() > 1)
+        {
+            isFlat = locatePointLine(
+                         vertices[t.vertices[ccw(i)]],
+                         vertices[linkStart[linkStart.size() - 2]],
+                         vertices[linkStart.back()]) ==
+                     PtLineLocation::OnLine;
+        }
+        iT = nextLinkTriangle(iT);
+        if(iT == iTstart)
+            break;
+    }
+    if(isFlat)
+    {
+        throw std::runtime_error(
+            "Triangulation can't be extended outside of super-triangle: "
+            "all vertices are collinear");
+    }
+    const std::size_t nLink = link.size();
+    std::vector<std::size_t> next(nLink), prev(nLink);
+    for(std::size_t i = 0; i < nLink; ++i)
+    {
+        next[i] = (i + 1) % nLink;
+        prev[next[i]] = i;
+    }
+    // 1. fill concave corners
+    std::vector<TriInd> filled;
+    std::vector<bool> isRemoved(nLink, false);
+    std::vector<std::size_t> toCheck;
+    toCheck.reserve(nLink);
+    for(std::size_t i = nLink; i != 0; --i)
+        toCheck.push_back(i - 1);
+    while(!toCheck.empty())
+    {
+        const std::size_t i = toCheck.back();
+        toCheck.pop_back();
+        if(isRemoved[i])
+            continue;
+        const std::size_t iNext = next[i];
+        const VertInd iV = linkStart[iNext];
+        const V2d<T>& v1 = vertices[linkStart[i]];
+        const V2d<T>& v2 = vertices[linkStart[next[iNext]]];
+        if(locatePointLine(v2, v1, vertices[iV]) != PtLineLocation::Left)
+            continue;
+        const TriInd iTfilled = fillLinkCorner(iV, link[i], link[iNext]);
+        filled.push_back(iTfilled);
+        const Triangle& t = triangles[iTfilled];
+        link[i] = t.neighbors[ccw(vertexInd(t, iV))];
+        isRemoved[iNext] = true;
+        next[i] = next[iNext];
+        prev[next[i]] = i;
+        toCheck.push_back(prev[i]);
+        toCheck.push_back(i);
+    }
+    // 2. replace link triangles with ghost triangles and remove the rest
+    std::size_t iFirst = 0;
+    while(isRemoved[iFirst])
+        ++iFirst;
+    std::vector<TriInd> ghosts;
+    std::size_t iLink = iFirst;
+    do
+    {
+        ghosts.push_back(link[iLink]);
+        iLink = next[iLink];
+    } while(iLink != iFirst);
+    std::vector<TriInd> superTris;
+    for(VertInd iV(0); iV < VertInd(3); ++iV)
+    {
+        superTris.insert(
+            superTris.end(), vertTris[iV].begin(), vertTris[iV].end());
+        vertTris[iV] = TriIndVec();
+    }
+    std::sort(superTris.begin(), superTris.end());
+    superTris.erase(
+        std::unique(superTris.begin(), superTris.end()), superTris.end());
+    std::vector<TriInd> sortedGhosts(ghosts);
+    std::sort(sortedGhosts.begin(), sortedGhosts.end());
+    for(TriIndCit it = superTris.begin(); it != superTris.end(); ++it)
+    {
+        if(std::binary_search(sortedGhosts.begin(), sortedGhosts.end(), *it))
+            continue;
+        const Triangle& t = triangles[*it];
+        for(Index i(0); i < Index(3); ++i)
+            if(t.vertices[i] >= 3)
+                removeAdjacentTriangle(t.vertices[i], *it);
+        m_dummyTris.push_back(*it);
+    }
+    using detail::arr3;
+    const std::size_t nGhosts = ghosts.size();
+    m_minVertex = linkStart[iFirst];
+    for(std::size_t i = 0; i < nGhosts; ++i)
+    {
+        Triangle& t = triangles[ghosts[i]];
+        const Index iE = detail::finiteEdgeInd(t);
+        const VertInd v1 = t.vertices[iE];
+        t = Triangle::make(
+            arr3(v1, t.vertices[ccw(iE)], ghostVertex),
+            arr3(
+                t.neighbors[iE],
+                ghosts[(i + 1) % nGhosts],
+                ghosts[(i + nGhosts - 1) % nGhosts]));
+        unsigned char& mask = m_fixedEdgeMasks[ghosts[i]];
+        mask = detail::edgeFlags(mask, iE);
+        if(detail::lessPoint(vertices[v1], vertices[m_minVertex]))
+            m_minVertex = v1;
+    }
+    m_superGeomType = SuperGeometryType::GhostVertex;
+    // 3. restore Delaunay property
+    std::vector<Edge> edges;
+    edges.reserve(3 * filled.size());
+    for(TriIndCit it = filled.begin(); it != filled.end(); ++it)
+    {
+        const VerticesArr3& vv = triangles[*it].vertices;
+        edges.push_back(Edge(vv[0], vv[1]));
+        edges.push_back(Edge(vv[1], vv[2]));
+        edges.push_back(Edge(vv[2], vv[0]));
+    }
+    flipEdgesUntilDelaunay(edges);
 }
 
+/// Flip non-fixed edges until they are Delaunay, edges around flipped edges
+/// are checked too. Consumes the edges (vector is empty after the call).
 template <typename T, typename TNearPointLocator>
-void Triangulation<T, TNearPointLocator>::addSuperTriangle(const Box2d<T>& box)
+void Triangulation<T, TNearPointLocator>::flipEdgesUntilDelaunay(
+    std::vector<Edge>& edges)
 {
-    m_nTargetVerts = 3;
-    m_superGeomType = SuperGeometryType::SuperTriangle;
-
-    const V2d<T> center = {
-        (box.min.x + box.max.x) / T(2), (box.min.y + box.max.y) / T(2)};
-    const T w = box.max.x - box.min.x;
-    const T h = box.max.y - box.min.y;
-    T r = std::sqrt(w * w + h * h) / T(2); // incircle radius
-    r *= T(1.1);
-    const T R = T(2) * r;                        // excircle radius
-    const T shiftX = R * std::sqrt(T(3)) / T(2); // R * cos(30 deg)
-    const V2d<T> posV1 = {center.x - shiftX, center.y - r};
-    const V2d<T> posV2 = {center.x + shiftX, center.y - r};
-    const V2d<T> posV3 = {center.x, center.y + R};
-    addNewVertex(posV1, TriIndVec(1, TriInd(0)));
-    addNewVertex(posV2, TriIndVec(1, TriInd(0)));
-    addNewVertex(posV3, TriIndVec(1, TriInd(0)));
-    const Triangle superTri = {
-        {VertInd(0), VertInd(1), VertInd(2)},
-        {noNeighbor, noNeighbor, noNeighbor}};
-    addTriangle(superTri);
-
-    m_nearPtLocator.addPoint(VertInd(0), vertices);
-    m_nearPtLocator.addPoint(VertInd(1), vertices);
-    m_nearPtLocator.addPoint(VertInd(2), vertices);
+    while(!edges.empty())
+    {
+        const Edge edge = edges.back();
+        edges.pop_back();
+        const TriInd iT = edgeTriangle(edge.v1(), edge.v2());
+        if(iT == noNeighbor) // edge was flipped already
+            continue;
+        const Triangle& t = triangles[iT];
+        const Index i = opposedTriangleInd(t, edge.v1(), edge.v2());
+        const TriInd iTopo = t.neighbors[i];
+        if(iTopo == noNeighbor || isGhost(iT) || isGhost(iTopo) ||
+           detail::edgeFlags(m_fixedEdgeMasks[iT], i) & detail::fixedEdgeBit)
+        {
+            continue;
+        }
+        const VertInd iV = t.vertices[cw(i)];
+        if(!isFlipNeeded(vertices[iV], iT, iTopo, iV))
+            continue;
+        flipEdge(iT, iTopo);
+        const TriInd flipped[] = {iT, iTopo};
+        for(int j = 0; j < 2; ++j)
+        {
+            const VerticesArr3& vv = triangles[flipped[j]].vertices;
+            edges.push_back(Edge(vv[0], vv[1]));
+            edges.push_back(Edge(vv[1], vv[2]));
+            edges.push_back(Edge(vv[2], vv[0]));
+        }
+    }
 }
 
 template <typename T, typename TNearPointLocator>
@@ -433,9 +1921,17 @@ void Triangulation<T, TNearPointLocator>::addNewVertex(
 
 template <typename T, typename TNearPointLocator>
 void Triangulation<T, TNearPointLocator>::insertVertex(const VertInd iVert)
+{
+    insertVertex(iVert, walkingSearchTrianglesAt(vertices[iVert]));
+}
+
+/// Insert vertex into already found triangle(s) at its position
+template <typename T, typename TNearPointLocator>
+void Triangulation<T, TNearPointLocator>::insertVertex(
+    const VertInd iVert,
+    const array<TriInd, 2>& trisAt)
 {
     const V2d<T>& v = vertices[iVert];
-    array<TriInd, 2> trisAt = walkingSearchTrianglesAt(v);
     std::stack<TriInd> triStack =
         trisAt[1] == noNeighbor
             ? insertPointInTriangle(iVert, trisAt[0])
@@ -446,9 +1942,14 @@ void Triangulation<T, TNearPointLocator>::insertVertex(const VertInd iVert)
         triStack.pop();
 
         const Triangle& t = triangles[iT];
-        const TriInd iTopo = opposedTriangle(t, iVert);
-        if(iTopo == noNeighbor)
+        const Index i = opposedTriangleInd(t, iVert);
+        const TriInd iTopo = t.neighbors[i];
+        // fixed edges inserted earlier are kept
+        if(iTopo == noNeighbor ||
+           detail::edgeFlags(m_fixedEdgeMasks[iT], i) & detail::fixedEdgeBit)
+        {
             continue;
+        }
         if(isFlipNeeded(v, iT, iTopo, iVert))
         {
             flipEdge(iT, iTopo);
@@ -458,6 +1959,70 @@ void Triangulation<T, TNearPointLocator>::insertVertex(const VertInd iVert)
     }
 
     m_nearPtLocator.addPoint(iVert, vertices);
+    if(m_superGeomType == SuperGeometryType::GhostVertex &&
+       detail::lessPoint(v, vertices[m_minVertex]))
+    {
+        m_minVertex = iVert;
+    }
+}
+
+/*!
+ * Insert chain vertex or weld it to the closest vertex of the triangles
+ * found at its position (and to the near point if welding distance is used).
+ * Search starts at the previous chain vertex if there is one.
+ * Custom super-geometry vertices have no chain index: throws if chain vertex
+ * should be welded to one of them.
+ */
+template <typename T, typename TNearPointLocator>
+VertInd Triangulation<T, TNearPointLocator>::insertChainVertex(
+    const V2d<T>& pos,
+    const VertInd iPrev,
+    const T weldEpsilon)
+{
+    const VertInd iStart = iPrev != noVertex
+                               ? iPrev
+                               : m_nearPtLocator.nearPoint(pos, vertices);
+    const array<TriInd, 2> trisAt = walkingSearchTrianglesAt(pos, iStart);
+    VertInd candidates[7];
+    std::size_t nCandidates = 0;
+    for(Index i(0); i < Index(2) && trisAt[i] != noNeighbor; ++i)
+    {
+        const VerticesArr3& vv = triangles[trisAt[i]].vertices;
+        candidates[nCandidates++] = vv[0];
+        candidates[nCandidates++] = vv[1];
+        candidates[nCandidates++] = vv[2];
+    }
+    if(weldEpsilon > T(0))
+        candidates[nCandidates++] = m_nearPtLocator.nearPoint(pos, vertices);
+    VertInd iWeld = noVertex;
+    T minDist = weldEpsilon * weldEpsilon;
+    for(std::size_t i = 0; i < nCandidates; ++i)
+    {
+        const VertInd iV = candidates[i];
+        // never weld to super-triangle vertices
+        if(iV == ghostVertex || (iV < m_nTargetVerts &&
+                                 m_superGeomType != SuperGeometryType::Custom))
+        {
+            continue;
+        }
+        const T dist = distanceSquared(pos, vertices[iV]);
+        if(dist <= minDist)
+        {
+            iWeld = iV;
+            minDist = dist;
+        }
+    }
+    if(iWeld < m_nTargetVerts) // custom super-geometry vertex
+    {
+        throw std::runtime_error(
+            "Chain point coincides with a custom super-geometry vertex");
+    }
+    if(iWeld != noVertex)
+        return iWeld;
+    addNewVertex(pos, TriIndVec());
+    const VertInd iV(vertices.size() - 1);
+    insertVertex(iV, trisAt);
+    return iV;
 }
 
 /*!
@@ -495,6 +2060,20 @@ bool Triangulation<T, TNearPointLocator>::isFlipNeeded(
     const VertInd iV2 = tOpo.vertices[i];
     const VertInd iV1 = tOpo.vertices[cw(i)];
     const VertInd iV3 = tOpo.vertices[ccw(i)];
+    if(m_superGeomType == SuperGeometryType::GhostVertex)
+    {
+        // Circumcircle of a ghost triangle degenerates to the open half-plane
+        // outside of its hull edge: flip if new vertex is strictly outside
+        if(iV2 == ghostVertex)
+            return locatePointLine(v, vertices[iV3], vertices[iV1]) ==
+                   PtLineLocation::Left;
+        if(iV1 == ghostVertex)
+            return locatePointLine(v, vertices[iV2], vertices[iV3]) ==
+                   PtLineLocation::Left;
+        if(iV3 == ghostVertex)
+            return locatePointLine(v, vertices[iV1], vertices[iV2]) ==
+                   PtLineLocation::Left;
+    }
     const V2d<T>& v1 = vertices[iV1];
     const V2d<T>& v2 = vertices[iV2];
     const V2d<T>& v3 = vertices[iV3];
@@ -566,6 +2145,11 @@ std::stack<TriInd> Triangulation<T, TNearPointLocator>::insertPointInTriangle(
     triangles[iNewT1] = Triangle::make(arr3(v2, v3, v), arr3(n2, iNewT2, iT));
     triangles[iNewT2] = Triangle::make(arr3(v3, v1, v), arr3(n3, iT, iNewT1));
     t = Triangle::make(arr3(v1, v2, v), arr3(n1, iNewT1, iNewT2));
+    // only outer edges can be fixed
+    const unsigned char mask = m_fixedEdgeMasks[iT];
+    m_fixedEdgeMasks[iNewT1] = detail::edgeFlags(mask, 1);
+    m_fixedEdgeMasks[iNewT2] = detail::edgeFlags(mask, 2);
+    m_fixedEdgeMasks[iT] = detail::edgeFlags(mask, 0);
     // make and add a new vertex
     addAdjacentTriangles(v, iT, iNewT1, iNewT2);
     // adjust lists of adjacent triangles for v1, v2, v3
@@ -614,17 +2198,30 @@ std::stack<TriInd> Triangulation<T, TNearPointLocator>::insertPointOnEdge(
     const VertInd v2 = t1.vertices[ccw(i)];
     const TriInd n1 = t1.neighbors[i];
     const TriInd n4 = t1.neighbors[cw(i)];
+    const unsigned char f1 = detail::edgeFlags(m_fixedEdgeMasks[iT1], i);
+    const unsigned char f4 = detail::edgeFlags(m_fixedEdgeMasks[iT1], cw(i));
+    const unsigned char fSplit =
+        detail::edgeFlags(m_fixedEdgeMasks[iT1], ccw(i));
     i = opposedVertexInd(t2, iT1);
     const VertInd v3 = t2.vertices[i];
     const VertInd v4 = t2.vertices[ccw(i)];
     const TriInd n3 = t2.neighbors[i];
     const TriInd n2 = t2.neighbors[cw(i)];
+    const unsigned char f3 = detail::edgeFlags(m_fixedEdgeMasks[iT2], i);
+    const unsigned char f2 = detail::edgeFlags(m_fixedEdgeMasks[iT2], cw(i));
     // add new triangles and change existing ones
     using detail::arr3;
     t1 = Triangle::make(arr3(v1, v2, v), arr3(n1, iTnew2, iTnew1));
     t2 = Triangle::make(arr3(v3, v4, v), arr3(n3, iTnew1, iTnew2));
     triangles[iTnew1] = Triangle::make(arr3(v1, v, v4), arr3(iT1, iT2, n4));
     triangles[iTnew2] = Triangle::make(arr3(v3, v, v2), arr3(iT2, iT1, n2));
+    // halves of a split fixed edge stay fixed
+    m_fixedEdgeMasks[iT1] = f1 | fSplit << 1;
+    m_fixedEdgeMasks[iT2] = f3 | fSplit << 1;
+    m_fixedEdgeMasks[iTnew1] = fSplit << 1 | f4 << 2;
+    m_fixedEdgeMasks[iTnew2] = fSplit << 1 | f2 << 2;
+    if(fSplit)
+        splitFixedEdge(Edge(v2, v4), v);
     // make and add new vertex
     addAdjacentTriangles(v, iT1, iTnew2, iT2, iTnew1);
     // adjust neighboring triangles and vertices
@@ -673,7 +2270,16 @@ TriInd Triangulation<T, TNearPointLocator>::walkTriangles(
     const V2d<T>& pos) const
 {
     // begin walk in search of triangle at pos
-    TriInd currTri = vertTris[startVertex][0];
+    TriIndVec::const_iterator itStart = vertTris[startVertex].begin();
+    if(m_superGeomType == SuperGeometryType::GhostVertex)
+    {
+        // replaced super-triangle vertices have no triangles
+        if(vertTris[startVertex].empty())
+            itStart = vertTris[m_minVertex].begin();
+        while(isGhost(*itStart))
+            ++itStart;
+    }
+    TriInd currTri = *itStart;
 #ifdef CDT_USE_BOOST
     TriIndFlatUSet visited;
 #else
@@ -702,6 +2308,12 @@ TriInd Triangulation<T, TNearPointLocator>::walkTriangles(
                 break;
             }
         }
+        // position is strictly outside of the hull edge of a ghost triangle
+        if(!found && m_superGeomType == SuperGeometryType::GhostVertex &&
+           isGhost(currTri))
+        {
+            break;
+        }
     }
     return currTri;
 }
@@ -710,11 +2322,24 @@ template <typename T, typename TNearPointLocator>
 array<TriInd, 2> Triangulation<T, TNearPointLocator>::walkingSearchTrianglesAt(
     const V2d<T>& pos) const
 {
-    array<TriInd, 2> out = {noNeighbor, noNeighbor};
     // Query  for a vertex close to pos, to start the search
-    const VertInd startVertex = m_nearPtLocator.nearPoint(pos, vertices);
+    return walkingSearchTrianglesAt(
+        pos, m_nearPtLocator.nearPoint(pos, vertices));
+}
+
+template <typename T, typename TNearPointLocator>
+array<TriInd, 2> Triangulation<T, TNearPointLocator>::walkingSearchTrianglesAt(
+    const V2d<T>& pos,
+    const VertInd startVertex) const
+{
+    array<TriInd, 2> out = {noNeighbor, noNeighbor};
     const TriInd iT = walkTriangles(startVertex, pos);
     // Finished walk, locate point in current triangle
+    if(m_superGeomType == SuperGeometryType::GhostVertex && isGhost(iT))
+    {
+        out[0] = iT;
+        return out;
+    }
     const Triangle& t = triangles[iT];
     const V2d<T>& v1 = vertices[t.vertices[0]];
     const V2d<T>& v2 = vertices[t.vertices[1]];
@@ -761,15 +2386,21 @@ void Triangulation<T, TNearPointLocator>::flipEdge(
     const VertInd v2 = triVs[ccw(i)];
     const TriInd n1 = triNs[i];
     const TriInd n3 = triNs[cw(i)];
+    const unsigned char f1 = detail::edgeFlags(m_fixedEdgeMasks[iT], i);
+    const unsigned char f3 = detail::edgeFlags(m_fixedEdgeMasks[iT], cw(i));
     i = opposedVertexInd(tOpo, iT);
     const VertInd v3 = triOpoVs[i];
     const VertInd v4 = triOpoVs[ccw(i)];
     const TriInd n4 = triOpoNs[i];
     const TriInd n2 = triOpoNs[cw(i)];
+    const unsigned char f4 = detail::edgeFlags(m_fixedEdgeMasks[iTopo], i);
+    const unsigned char f2 = detail::edgeFlags(m_fixedEdgeMasks[iTopo], cw(i));
     // change vertices and neighbors
     using detail::arr3;
     t = Triangle::make(arr3(v4, v1, v3), arr3(n3, iTopo, n4));
     tOpo = Triangle::make(arr3(v2, v3, v1), arr3(n2, iT, n1));
+    m_fixedEdgeMasks[iT] = f3 | f4 << 2;
+    m_fixedEdgeMasks[iTopo] = f2 | f1 << 2;
     // adjust neighboring triangles and vertices
     changeNeighbor(n1, iT, iTopo);
     changeNeighbor(n4, iTopo, iT);
@@ -796,6 +2427,8 @@ void Triangulation<T, TNearPointLocator>::addAdjacentTriangle(
     const VertInd iVertex,
     const TriInd iTriangle)
 {
+    if(iVertex == ghostVertex)
+        return;
     vertTris[iVertex].push_back(iTriangle);
 }
 
@@ -834,83 +2467,311 @@ void Triangulation<T, TNearPointLocator>::removeAdjacentTriangle(
     const VertInd iVertex,
     const TriInd iTriangle)
 {
+    if(iVertex == ghostVertex)
+        return;
     std::vector<TriInd>& tris = vertTris[iVertex];
     tris.erase(std::find(tris.begin(), tris.end(), iTriangle));
 }
 
-/// Split points collection to points before and after given vertex index
-inline std::pair<std::vector<VertInd>, std::vector<VertInd> >
-splitPseudopolygon(const VertInd vi, const std::vector<VertInd>& points)
-{
-    std::pair<std::vector<VertInd>, std::vector<VertInd> > out;
-    std::vector<VertInd>::const_iterator it;
-    for(it = points.begin(); vi != *it; ++it)
-        out.first.push_back(*it);
-    for(it = it + 1; it != points.end(); ++it)
-        out.second.push_back(*it);
-    return out;
-}
-
+/*!
+ * Delaunay triangulation of a pseudo-polygon. Triangles are built in reused
+ * buffers with local vertex indices: chain from edge's start (0) through
+ * @p points to edge's end. Only the resulting triangles are added to the
+ * triangulation.
+ * @param ia,ib edge's end-points
+ * @param points polygon's vertices on the left of the edge ordered from
+ * @p ia to @p ib
+ * @returns triangle containing the edge
+ */
 template <typename T, typename TNearPointLocator>
 TriInd Triangulation<T, TNearPointLocator>::triangulatePseudopolygon(
     const VertInd ia,
     const VertInd ib,
-    const std::vector<VertInd>& points)
+    const std::vector<VertInd>& points,
+    detail::EdgeInsertionContext& ctx)
 {
     if(points.empty())
         return pseudopolyOuterTriangle(ia, ib);
-    const VertInd ic = findDelaunayPoint(ia, ib, points);
-    const std::pair<std::vector<VertInd>, std::vector<VertInd> > splitted =
-        splitPseudopolygon(ic, points);
-    // triangulate splitted pseudo-polygons
-    TriInd iT2 = triangulatePseudopolygon(ic, ib, splitted.second);
-    TriInd iT1 = triangulatePseudopolygon(ia, ic, splitted.first);
-    // add new triangle
-    const Triangle t = {{ia, ib, ic}, {noNeighbor, iT2, iT1}};
-    const TriInd iT = addTriangle(t);
-    // adjust neighboring triangles and vertices
-    if(iT1 != noNeighbor)
+    detail::PseudopolyBuffers& buf = ctx.pseudopoly;
+    std::vector<VertInd>& verts = buf.vertices;
+    verts.resize(points.size() + 2);
+    verts.front() = ia;
+    std::copy(points.begin(), points.end(), verts.begin() + 1);
+    verts.back() = ib;
+    // Chain visits a vertex more than once when the removed triangles
+    // surround an edge from both sides (e.g., long edges to super-triangle)
+    std::vector<bool>& isInChain = buf.isInChain;
+    isInChain.resize(vertices.size(), false);
+    bool isSimple = true;
+    typedef std::vector<VertInd>::const_iterator VertIndCit;
+    for(VertIndCit it = points.begin(); it != points.end(); ++it)
+    {
+        isSimple = isSimple && !isInChain[*it];
+        isInChain[*it] = true;
+    }
+    for(VertIndCit it = points.begin(); it != points.end(); ++it)
+        isInChain[*it] = false;
+    buf.triangles.clear();
+    if(!isSimple || !triangulatePseudopolygonRandomized(buf))
     {
-        if(splitted.first.empty())
-            changeNeighbor(iT1, ia, ic, iT);
-        else
-            triangles[iT1].neighbors[0] = iT;
+        buf.triangles.clear();
+        triangulatePseudopolygonSplitting(buf);
     }
-    if(iT2 != noNeighbor)
+    return addPseudopolygonTriangles(
+        buf, ctx.isParallel ? ctx.dummyTris : m_dummyTris);
+}
+
+/*!
+ * Triangulate pseudo-polygon in local buffers: divide-and-conquer algorithm
+ * by Anglada with an explicit stack. Pseudo-polygon (v1, v2) is split at the
+ * vertex c forming Delaunay triangle (v1, v2, c) into pseudo-polygons
+ * (v1, c) and (c, v2). Handles chains that visit a vertex more than once.
+ */
+template <typename T, typename TNearPointLocator>
+void Triangulation<T, TNearPointLocator>::triangulatePseudopolygonSplitting(
+    detail::PseudopolyBuffers& buf)
+{
+    typedef detail::PseudopolyBuffers::Step Step;
+    const std::vector<VertInd>& verts = buf.vertices;
+    TriangleVec& tris = buf.triangles;
+    std::vector<Step>& steps = buf.steps;
+    steps.push_back(Step(VertInd(0), VertInd(verts.size() - 1), noNeighbor));
+    using detail::arr3;
+    while(!steps.empty())
     {
-        if(splitted.second.empty())
-            changeNeighbor(iT2, ic, ib, iT);
-        else
-            triangles[iT2].neighbors[0] = iT;
+        const Step step = steps.back();
+        steps.pop_back();
+        // find Delaunay point
+        const V2d<T>& v1 = vertices[verts[step.v1]];
+        const V2d<T>& v2 = vertices[verts[step.v2]];
+        VertInd c = step.v1 + 1;
+        for(VertInd i = c + 1; i < step.v2; ++i)
+            if(isInCircumcircle(
+                   vertices[verts[i]], v1, v2, vertices[verts[c]]))
+            {
+                c = i;
+            }
+        // add triangle and split
+        const TriInd iT(tris.size());
+        tris.push_back(Triangle::make(
+            arr3(step.v1, step.v2, c),
+            arr3(step.iT, noNeighbor, noNeighbor)));
+        if(step.iT != noNeighbor)
+        {
+            Triangle& tParent = tris[step.iT];
+            tParent.neighbors[opposedTriangleInd(tParent, step.v1, step.v2)] =
+                iT;
+        }
+        if(step.v2 - c > 1)
+            steps.push_back(Step(c, step.v2, iT));
+        if(c - step.v1 > 1)
+            steps.push_back(Step(step.v1, c, iT));
     }
-    addAdjacentTriangle(ia, iT);
-    addAdjacentTriangle(ib, iT);
-    addAdjacentTriangle(ic, iT);
+}
 
-    return iT;
+namespace detail
+{
+
+/// Next pseudo-random number of a 64-bit linear congruential generator
+inline unsigned long long nextRandom(unsigned long long& state)
+{
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state >> 33;
 }
 
+} // namespace detail
+
+/*!
+ * Triangulate pseudo-polygon in local buffers: Chew's randomized incremental
+ * algorithm as adapted by Shewchuk and Brown for cavities of inserted edges.
+ * Runs in expected linear time.
+ *  - chain vertices are removed from the chain in random order
+ *  - vertices are inserted back in reverse order: inserted vertex digs a
+ *    cavity of triangles whose circumcircles contain it (or which would make
+ *    a new triangle inverted) and the cavity is triangulated as a fan
+ * Removing a reflex vertex makes the remaining chain self-overlapping and for
+ * some insertion orders the result has inverted or non-Delaunay triangles.
+ * @returns false if result is not a constrained Delaunay triangulation
+ */
 template <typename T, typename TNearPointLocator>
-VertInd Triangulation<T, TNearPointLocator>::findDelaunayPoint(
-    const VertInd ia,
-    const VertInd ib,
-    const std::vector<VertInd>& points) const
-{
-    assert(!points.empty());
-    const V2d<T>& a = vertices[ia];
-    const V2d<T>& b = vertices[ib];
-    VertInd ic = points.front();
-    V2d<T> c = vertices[ic];
-    typedef std::vector<VertInd>::const_iterator CIt;
-    for(CIt it = points.begin() + 1; it != points.end(); ++it)
-    {
-        const V2d<T> v = vertices[*it];
-        if(!isInCircumcircle(v, a, b, c))
+bool Triangulation<T, TNearPointLocator>::triangulatePseudopolygonRandomized(
+    detail::PseudopolyBuffers& buf)
+{
+    typedef detail::PseudopolyBuffers::Step Step;
+    const std::vector<VertInd>& verts = buf.vertices;
+    const VertInd n(verts.size());
+    std::vector<VertInd>& prev = buf.prev;
+    std::vector<VertInd>& next = buf.next;
+    prev.resize(n);
+    next.resize(n);
+    for(VertInd i(0); i < n; ++i)
+    {
+        prev[i] = i - 1;
+        next[i] = i + 1;
+    }
+    std::vector<VertInd>& order = buf.order;
+    order.resize(n - 2);
+    for(VertInd i(0); i < n - 2; ++i)
+    {
+        order[i] = i + 1;
+        std::swap(order[i], order[detail::nextRandom(buf.randState) % (i + 1)]);
+    }
+    // removed vertex remembers its neighbors to be inserted back between them
+    for(VertInd i = n - 3; i > 0; --i)
+    {
+        const VertInd iV = order[i];
+        next[prev[iV]] = next[iV];
+        prev[next[iV]] = prev[iV];
+    }
+    using detail::arr3;
+    TriangleVec& tris = buf.triangles;
+    tris.push_back(Triangle::make(
+        arr3(order[0], VertInd(0), VertInd(n - 1)),
+        arr3(noNeighbor, noNeighbor, noNeighbor)));
+    // triangle on the inner side of each chain edge (v, next[v])
+    std::vector<TriInd>& chainTris = buf.chainTris;
+    chainTris.resize(n);
+    chainTris[0] = chainTris[order[0]] = TriInd(0);
+    // step: add triangle (u, v1, v2) or dig through triangle across (v1, v2)
+    std::vector<Step>& steps = buf.steps;
+    for(VertInd i(1); i < n - 2; ++i)
+    {
+        const VertInd u = order[i];
+        const VertInd v = prev[u], w = next[u];
+        const V2d<T>& pos = vertices[verts[u]];
+        steps.push_back(Step(v, w, chainTris[v]));
+        TriInd iTprev(noNeighbor);
+        while(!steps.empty())
+        {
+            const Step step = steps.back();
+            steps.pop_back();
+            const V2d<T>& v1 = vertices[verts[step.v1]];
+            const V2d<T>& v2 = vertices[verts[step.v2]];
+            if(step.iT != noNeighbor)
+            {
+                Triangle& tOpo = tris[step.iT];
+                const Index i2 = vertexInd(tOpo, step.v2);
+                const VertInd x = tOpo.vertices[cw(i2)];
+                if(locatePointLine(pos, v1, v2) != PtLineLocation::Left ||
+                   isInCircumcircle(vertices[verts[x]], pos, v1, v2))
+                {
+                    steps.push_back(Step(x, step.v2, tOpo.neighbors[cw(i2)]));
+                    steps.push_back(Step(step.v1, x, tOpo.neighbors[ccw(i2)]));
+                    tOpo.vertices[0] = noVertex; // mark as removed
+                    continue;
+                }
+            }
+            // add triangle to the fan around new vertex
+            const TriInd iT(tris.size());
+            tris.push_back(Triangle::make(
+                arr3(u, step.v1, step.v2),
+                arr3(iTprev, step.iT, noNeighbor)));
+            if(iTprev != noNeighbor)
+                tris[iTprev].neighbors[2] = iT;
+            else
+                chainTris[v] = iT;
+            if(step.iT != noNeighbor)
+            {
+                Triangle& tOpo = tris[step.iT];
+                tOpo.neighbors[vertexInd(tOpo, step.v2)] = iT;
+            }
+            else if(step.v1 != 0 || step.v2 != n - 1) // chain edge
+                chainTris[step.v2] = iT;
+            iTprev = iT;
+        }
+        chainTris[u] = iTprev;
+        next[v] = prev[w] = u;
+    }
+    return isPseudopolygonTriangulationDelaunay(buf);
+}
+
+/// Check that triangles in local buffers are counter-clockwise and that
+/// edges between them are Delaunay: then triangulation is the polygon's CDT
+template <typename T, typename TNearPointLocator>
+bool Triangulation<T, TNearPointLocator>::
+    isPseudopolygonTriangulationDelaunay(
+        const detail::PseudopolyBuffers& buf) const
+{
+    const std::vector<VertInd>& verts = buf.vertices;
+    const TriangleVec& tris = buf.triangles;
+    for(TriInd iT(0); iT < TriInd(tris.size()); ++iT)
+    {
+        const Triangle& t = tris[iT];
+        if(t.vertices[0] == noVertex)
+            continue;
+        const V2d<T>& v1 = vertices[verts[t.vertices[0]]];
+        const V2d<T>& v2 = vertices[verts[t.vertices[1]]];
+        const V2d<T>& v3 = vertices[verts[t.vertices[2]]];
+        if(locatePointLine(v3, v1, v2) != PtLineLocation::Left)
+            return false;
+        for(Index i(0); i < Index(3); ++i)
+        {
+            const TriInd iTn = t.neighbors[i];
+            if(iTn == noNeighbor || iTn < iT)
+                continue;
+            const Triangle& tn = tris[iTn];
+            const VertInd iVn =
+                tn.vertices[ccw(vertexInd(tn, t.vertices[i]))];
+            if(isInCircumcircle(vertices[verts[iVn]], v1, v2, v3))
+                return false;
+        }
+    }
+    return true;
+}
+
+/// Add pseudo-polygon triangles from local buffers to the triangulation and
+/// link them to the outer triangles, returns triangle containing the edge
+template <typename T, typename TNearPointLocator>
+TriInd Triangulation<T, TNearPointLocator>::addPseudopolygonTriangles(
+    detail::PseudopolyBuffers& buf,
+    std::vector<TriInd>& dummyTris)
+{
+    const std::vector<VertInd>& verts = buf.vertices;
+    const VertInd iVlast(verts.size() - 1);
+    const TriangleVec& tris = buf.triangles;
+    std::vector<TriInd>& triInds = buf.triInds;
+    triInds.resize(tris.size());
+    for(TriInd iT(0); iT < TriInd(tris.size()); ++iT)
+        if(tris[iT].vertices[0] != noVertex)
+            triInds[iT] = addTriangle(dummyTris);
+    TriInd iTedge(noNeighbor);
+    for(TriInd iT(0); iT < TriInd(tris.size()); ++iT)
+    {
+        const Triangle& tLocal = tris[iT];
+        if(tLocal.vertices[0] == noVertex)
             continue;
-        ic = *it;
-        c = vertices[ic];
+        Triangle& t = triangles[triInds[iT]];
+        unsigned char mask = 0;
+        for(Index i(0); i < Index(3); ++i)
+        {
+            const VertInd iV1 = tLocal.vertices[i];
+            const VertInd iV2 = tLocal.vertices[ccw(i)];
+            t.vertices[i] = verts[iV1];
+            if(tLocal.neighbors[i] != noNeighbor)
+            {
+                t.neighbors[i] = triInds[tLocal.neighbors[i]];
+                continue;
+            }
+            if(iV1 == 0 && iV2 == iVlast)
+            {
+                t.neighbors[i] = noNeighbor;
+                iTedge = triInds[iT];
+                continue;
+            }
+            // edges on pseudo-polygon's border keep flags of removed triangles
+            const TriInd iTout =
+                pseudopolyOuterTriangle(verts[iV1], verts[iV2]);
+            t.neighbors[i] = iTout;
+            mask |= edgeFlags(iTout, verts[iV1], verts[iV2]) << i;
+            if(iTout != noNeighbor)
+                changeNeighbor(iTout, verts[iV1], verts[iV2], triInds[iT]);
+        }
+        m_fixedEdgeMasks[triInds[iT]] = mask;
+        // chain visiting an edge twice finds the added triangle as outer one
+        for(Index i(0); i < Index(3); ++i)
+            addAdjacentTriangle(t.vertices[i], triInds[iT]);
     }
-    return ic;
+    return iTedge;
 }
 
 template <typename T, typename TNearPointLocator>
@@ -918,13 +2779,8 @@ TriInd Triangulation<T, TNearPointLocator>::pseudopolyOuterTriangle(
     const VertInd ia,
     const VertInd ib) const
 {
-    const std::vector<TriInd>& aTris = vertTris[ia];
-    const std::vector<TriInd>& bTris = vertTris[ib];
-    typedef std::vector<TriInd>::const_iterator TriIndCit;
-    for(TriIndCit it = aTris.begin(); it != aTris.end(); ++it)
-        if(std::find(bTris.begin(), bTris.end(), *it) != bTris.end())
-            return *it;
-    return noNeighbor;
+    return vertTris[ia].size() <= vertTris[ib].size() ? edgeTriangle(ia, ib)
+                                                      : edgeTriangle(ib, ia);
 }
 
 template <typename T, typename TNearPointLocator>
@@ -935,6 +2791,24 @@ void Triangulation<T, TNearPointLocator>::insertVertices(
         newVertices.begin(), newVertices.end(), getX_V2d<T>, getY_V2d<T>);
 }
 
+template <typename T, typename TNearPointLocator>
+std::vector<VertInd> Triangulation<T, TNearPointLocator>::insertPolyline(
+    const std::vector<V2d<T> >& points,
+    const T weldEpsilon)
+{
+    return insertPolyline(
+        points.begin(), points.end(), getX_V2d<T>, getY_V2d<T>, weldEpsilon);
+}
+
+template <typename T, typename TNearPointLocator>
+std::vector<VertInd> Triangulation<T, TNearPointLocator>::insertRing(
+    const std::vector<V2d<T> >& points,
+    const T weldEpsilon)
+{
+    return insertRing(
+        points.begin(), points.end(), getX_V2d<T>, getY_V2d<T>, weldEpsilon);
+}
+
 template <typename T>
 DuplicatesInfo RemoveDuplicates(std::vector<V2d<T> >& vertices)
 {
@@ -947,9 +2821,14 @@ DuplicatesInfo RemoveDuplicates(std::vector<V2d<T> >& vertices)
 CDT_INLINE_IF_HEADER_ONLY void
 RemapEdges(std::vector<Edge>& edges, const std::vector<std::size_t>& mapping)
 {
-    for(std::vector<Edge>::iterator it = edges.begin(); it != edges.end(); ++it)
+    const std::ptrdiff_t nEdges = edges.size();
+#ifdef _OPENMP
+#pragma omp parallel for if(nEdges >= minParallelLoopSize)
+#endif
+    for(std::ptrdiff_t i = 0; i < nEdges; ++i)
     {
-        *it = Edge(mapping[it->v1()], mapping[it->v2()]); // remap
+        const Edge& e = edges[i];
+        edges[i] = Edge(mapping[e.v1()], mapping[e.v2()]); // remap
     }
 }
 
@@ -962,12 +2841,22 @@ DuplicatesInfo RemoveDuplicatesAndRemapEdges(
         vertices, edges, getX_V2d<T>, getY_V2d<T>);
 }
 
+template <typename T>
+DuplicatesInfo RemoveNearDuplicatesAndRemapEdges(
+    std::vector<V2d<T> >& vertices,
+    std::vector<Edge>& edges,
+    const T epsilon)
+{
+    return RemoveNearDuplicatesAndRemapEdges<T>(
+        vertices, edges, epsilon, getX_V2d<T>, getY_V2d<T>);
+}
+
 CDT_INLINE_IF_HEADER_ONLY
 unordered_map<TriInd, LayerDepth> PeelLayer(
     std::stack<TriInd> seeds,
     const TriangleVec& triangles,
     const EdgeUSet& fixedEdges,
-    const unordered_map<Edge, BoundaryOverlapCount>& overlapCount,
+    const EdgeOverlapCountUMap& overlapCount,
     const LayerDepth layerDepth,
     std::vector<LayerDepth>& triDepths)
 {
@@ -987,7 +2876,7 @@ unordered_map<TriInd, LayerDepth> PeelLayer(
                 continue;
             if(fixedEdges.count(opEdge))
             {
-                const unordered_map<Edge, LayerDepth>::const_iterator cit =
+                const EdgeOverlapCountUMap::const_iterator cit =
                     overlapCount.find(opEdge);
                 const LayerDepth triDepth = cit == overlapCount.end()
                                                 ? layerDepth + 1
@@ -1039,34 +2928,14 @@ std::vector<LayerDepth> CalculateTriangleDepths(
     const TriInd seed,
     const TriangleVec& triangles,
     const EdgeUSet& fixedEdges,
-    const unordered_map<Edge, BoundaryOverlapCount>& overlapCount)
+    const EdgeOverlapCountUMap& overlapCount)
 {
-    std::vector<LayerDepth> triDepths(
-        triangles.size(), std::numeric_limits<LayerDepth>::max());
-    std::stack<TriInd> seeds(TriDeque(1, seed));
-    LayerDepth layerDepth = 0;
-    LayerDepth deepestSeedDepth = 0;
-
-    unordered_map<LayerDepth, TriIndUSet> seedsByDepth;
-    do
-    {
-        const unordered_map<TriInd, LayerDepth>& newSeeds = PeelLayer(
-            seeds, triangles, fixedEdges, overlapCount, layerDepth, triDepths);
-
-        seedsByDepth.erase(layerDepth);
-        typedef unordered_map<TriInd, LayerDepth>::const_iterator Iter;
-        for(Iter it = newSeeds.begin(); it != newSeeds.end(); ++it)
-        {
-            deepestSeedDepth = std::max(deepestSeedDepth, it->second);
-            seedsByDepth[it->second].insert(it->first);
-        }
-        const TriIndUSet& nextLayerSeeds = seedsByDepth[layerDepth + 1];
-        seeds = std::stack<TriInd>(
-            TriDeque(nextLayerSeeds.begin(), nextLayerSeeds.end()));
-        ++layerDepth;
-    } while(!seeds.empty() || deepestSeedDepth > layerDepth);
-
-    return triDepths;
+    return detail::calculateTriangleDepths(
+        seed,
+        triangles,
+        detail::fixedEdgeMasks(triangles, fixedEdges, &overlapCount),
+        overlapCount,
+        NULL);
 }
 
 CDT_INLINE_IF_HEADER_ONLY
@@ -1075,19 +2944,12 @@ std::vector<LayerDepth> CalculateTriangleDepths(
     const TriangleVec& triangles,
     const EdgeUSet& fixedEdges)
 {
-    std::vector<LayerDepth> triDepths(
-        triangles.size(), std::numeric_limits<LayerDepth>::max());
-    std::stack<TriInd> seeds(TriDeque(1, seed));
-    LayerDepth layerDepth = 0;
-
-    do
-    {
-        const TriIndUSet& newSeeds =
-            PeelLayer(seeds, triangles, fixedEdges, layerDepth++, triDepths);
-        seeds = std::stack<TriInd>(TriDeque(newSeeds.begin(), newSeeds.end()));
-    } while(!seeds.empty());
-
-    return triDepths;
+    return detail::calculateTriangleDepths(
+        seed,
+        triangles,
+        detail::fixedEdgeMasks(triangles, fixedEdges, NULL),
+        EdgeOverlapCountUMap(),
+        NULL);
 }
 
 CDT_INLINE_IF_HEADER_ONLY EdgeUSet
@@ -1104,4 +2966,98 @@ extractEdgesFromTriangles(const TriangleVec& triangles)
     return edges;
 }
 
+CDT_INLINE_IF_HEADER_ONLY EdgeToEdgesUMap
+EdgeToPiecesMapping(const EdgeToEdgesUMap& pieceToOriginals)
+{
+    EdgeToEdgesUMap edgeToPieces;
+    typedef EdgeToEdgesUMap::const_iterator Cit;
+    typedef std::vector<Edge>::const_iterator EdgeCit;
+    for(Cit it = pieceToOriginals.begin(); it != pieceToOriginals.end(); ++it)
+    {
+        const std::vector<Edge>& originals = it->second;
+        for(EdgeCit e = originals.begin(); e != originals.end(); ++e)
+            if(*e != it->first) // piece is also an original edge itself
+                edgeToPieces[*e].push_back(it->first);
+    }
+    return edgeToPieces;
+}
+
+CDT_INLINE_IF_HEADER_ONLY EdgeToVerticesUMap
+EdgeToSplitVertices(const EdgeToEdgesUMap& edgeToPieces)
+{
+    EdgeToVerticesUMap edgeToVertices;
+    typedef std::pair<VertInd, VertInd> Link;
+    typedef std::vector<Link>::const_iterator LinkCit;
+    std::vector<Link> links; // pieces in both directions sorted by start
+    typedef EdgeToEdgesUMap::const_iterator Cit;
+    typedef std::vector<Edge>::const_iterator EdgeCit;
+    for(Cit it = edgeToPieces.begin(); it != edgeToPieces.end(); ++it)
+    {
+        const std::vector<Edge>& pieces = it->second;
+        links.clear();
+        for(EdgeCit e = pieces.begin(); e != pieces.end(); ++e)
+        {
+            links.push_back(std::make_pair(e->v1(), e->v2()));
+            links.push_back(std::make_pair(e->v2(), e->v1()));
+        }
+        std::sort(links.begin(), links.end());
+        const Edge& edge = it->first;
+        std::vector<VertInd>& chain = edgeToVertices[edge];
+        chain.reserve(pieces.size() + 1);
+        VertInd iPrev = noVertex;
+        VertInd iV = edge.v1();
+        chain.push_back(iV);
+        while(iV != edge.v2() && chain.size() <= pieces.size())
+        {
+            // vertex is linked to the previous vertex and the next one
+            LinkCit l =
+                std::lower_bound(links.begin(), links.end(), Link(iV, 0));
+            while(l != links.end() && l->first == iV && l->second == iPrev)
+                ++l;
+            if(l == links.end() || l->first != iV) // piece was erased
+                break;
+            iPrev = iV;
+            iV = l->second;
+            chain.push_back(iV);
+        }
+    }
+    return edgeToVertices;
+}
+
+CDT_INLINE_IF_HEADER_ONLY std::vector<Edge>
+extractEdgeVectorFromTriangles(const TriangleVec& triangles)
+{
+    // count edges taken from each triangle, then fill at prefix-sum offsets
+    const std::ptrdiff_t nTris = triangles.size();
+    std::vector<std::size_t> offsets(nTris + 1, 0);
+#ifdef _OPENMP
+#pragma omp parallel for if(nTris >= minParallelLoopSize)
+#endif
+    for(std::ptrdiff_t iT = 0; iT < nTris; ++iT)
+    {
+        const NeighborsArr3& nn = triangles[iT].neighbors;
+        for(Index i(0); i < Index(3); ++i)
+            if(nn[i] == noNeighbor || nn[i] > TriInd(iT))
+                ++offsets[iT + 1];
+    }
+    for(std::ptrdiff_t iT = 0; iT < nTris; ++iT)
+        offsets[iT + 1] += offsets[iT];
+    std::vector<Edge> edges(offsets.back(), Edge(VertInd(0), VertInd(0)));
+#ifdef _OPENMP
+#pragma omp parallel for if(nTris >= minParallelLoopSize)
+#endif
+    for(std::ptrdiff_t iT = 0; iT < nTris; ++iT)
+    {
+        const Triangle& t = triangles[iT];
+        std::size_t iE = offsets[iT];
+        for(Index i(0); i < Index(3); ++i)
+        {
+            const TriInd iN = t.neighbors[i];
+            if(iN == noNeighbor || iN > TriInd(iT))
+                edges[iE++] = Edge(t.vertices[i], t.vertices[ccw(i)]);
+        }
+    }
+    return edges;
+}
+
 } // namespace CDT
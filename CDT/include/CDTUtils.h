@@ -40,8 +40,11 @@ typedef char couldnt_parse_cxx_standard[-1]; ///< Error: couldn't parse standard
 #define CDT_EXPORT
 #endif
 
+#include "FlatHashTable.h"
+
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <limits>
 #include <vector>
 
@@ -145,6 +148,12 @@ BOOST_STRONG_TYPEDEF(IndexSizeType, VertInd);
 BOOST_STRONG_TYPEDEF(IndexSizeType, TriInd);
 #endif
 
+/**
+ * Loops over at least this many elements run in parallel when OpenMP is
+ * enabled (e.g., with CDT_USE_OPENMP CMake option)
+ */
+const static std::ptrdiff_t minParallelLoopSize(100000);
+
 typedef std::vector<TriInd> TriIndVec;  ///< Vector of triangle indices
 typedef array<VertInd, 3> VerticesArr3; ///< array of three vertex indices
 typedef array<TriInd, 3> NeighborsArr3; ///< array of three neighbors
@@ -193,6 +202,8 @@ struct CDT_EXPORT Edge
     Edge(VertInd iV1, VertInd iV2);
     /// Assignment operator
     bool operator==(const Edge& other) const;
+    /// Inequality operator
+    bool operator!=(const Edge& other) const;
     /// V1 getter
     VertInd v1() const;
     /// V2 getter
@@ -216,9 +227,41 @@ inline VertInd edge_get_v2(const Edge& e)
     return e.v2();
 }
 
-typedef unordered_set<Edge> EdgeUSet;             ///< Hash table of edges
-typedef unordered_set<TriInd> TriIndUSet;         ///< Hash table of triangles
-typedef unordered_map<TriInd, TriInd> TriIndUMap; ///< Triangle hash map
+/// Hasher of vertex or triangle index
+struct IndexHash
+{
+    /// Hash operator
+    std::size_t operator()(const IndexSizeType i) const
+    {
+        return mixHash(i);
+    }
+};
+
+/// Hasher of edge
+struct EdgeHash
+{
+    /// Hash operator
+    std::size_t operator()(const Edge& e) const
+    {
+        return mixHash(mixHash(e.v1()) + e.v2());
+    }
+};
+
+/// Hasher of 2D vector: points with equal coordinates hash equally
+template <typename T>
+struct V2dHash
+{
+    /// Hash operator
+    std::size_t operator()(const V2d<T>& v) const
+    {
+        return mixHash(floatBits(v.x) ^ mixHash(floatBits(v.y)));
+    }
+};
+
+typedef FlatHashSet<Edge, EdgeHash> EdgeUSet;       ///< Hash table of edges
+typedef FlatHashSet<TriInd, IndexHash> TriIndUSet; ///< Hash table of triangles
+/// Triangle hash map
+typedef FlatHashMap<TriInd, TriInd, IndexHash> TriIndUMap;
 #ifdef CDT_USE_BOOST
 /// Flat hash table of triangles
 typedef boost::container::flat_set<TriInd> TriIndFlatUSet;
@@ -359,6 +402,31 @@ CDT_EXPORT T distance(const V2d<T>& a, const V2d<T>& b);
 template <typename T>
 CDT_EXPORT T distanceSquared(const V2d<T>& a, const V2d<T>& b);
 
+/**
+ * Position of the crossing of segments (p1, p2) and (p3, p4) that properly
+ * intersect (rounding policy of intersection vertices):
+ *  - parameters along both segments are ratios of robust orientations
+ *  - each coordinate is interpolated on the segment with the shorter
+ *    projection onto that axis (smaller absolute error)
+ *  - result is rounded to @p T and clamped to the overlap of segments'
+ *    bounding boxes that contains the exact intersection
+ */
+template <typename T>
+CDT_EXPORT V2d<T> intersectionPosition(
+    const V2d<T>& p1,
+    const V2d<T>& p2,
+    const V2d<T>& p3,
+    const V2d<T>& p4);
+
+/**
+ * If point is closer to the line (a, b) than the rounding error of
+ * intersection positions (see @ref intersectionPosition): 16 machine
+ * epsilons of the largest absolute coordinate
+ */
+template <typename T>
+CDT_EXPORT bool
+isWithinRoundingError(const V2d<T>& p, const V2d<T>& a, const V2d<T>& b);
+
 } // namespace CDT
 
 #ifndef CDT_USE_AS_COMPILED_LIBRARY
@@ -408,29 +476,7 @@ struct hash<CDT::Edge>
     /// Hash operator
     std::size_t operator()(const CDT::Edge& e) const
     {
-        return hashEdge(e);
-    }
-
-private:
-    static void hashCombine(std::size_t& seed, const CDT::VertInd& key)
-    {
-#ifdef CDT_CXX11_IS_SUPPORTED
-        typedef std::hash<CDT::VertInd> Hasher;
-#else
-        typedef boost::hash<CDT::VertInd> Hasher;
-#endif
-        seed ^= Hasher()(key) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-    }
-    static std::size_t hashEdge(const CDT::Edge& e)
-    {
-        const std::pair<CDT::VertInd, CDT::VertInd>& vv = e.verts();
-        std::size_t seed1(0);
-        hashCombine(seed1, vv.first);
-        hashCombine(seed1, vv.second);
-        std::size_t seed2(0);
-        hashCombine(seed2, vv.second);
-        hashCombine(seed2, vv.first);
-        return std::min(seed1, seed2);
+        return CDT::EdgeHash()(e);
     }
 };
 } // namespace std/boost
@@ -13,6 +13,7 @@
 #include "predicates.h" // robust predicates: orient, in-circle
 //! @}
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace CDT
@@ -51,6 +52,11 @@ CDT_INLINE_IF_HEADER_ONLY bool Edge::operator==(const Edge& other) const
     return m_vertices == other.m_vertices;
 }
 
+CDT_INLINE_IF_HEADER_ONLY bool Edge::operator!=(const Edge& other) const
+{
+    return !(*this == other);
+}
+
 CDT_INLINE_IF_HEADER_ONLY VertInd Edge::v1() const
 {
     return m_vertices.first;
@@ -261,4 +267,72 @@ T distanceSquared(const V2d<T>& a, const V2d<T>& b)
     return distanceSquared(a.x, a.y, b.x, b.y);
 }
 
+namespace detail
+{
+
+/// Linear interpolation between @p a and @p b at parameter @p t
+template <typename T>
+T lerp(const T a, const T b, const T t)
+{
+    return (T(1) - t) * a + t * b;
+}
+
+/// Clamp value to the range between two bounds given in any order
+template <typename T>
+T clampBetween(const T v, const T bound1, const T bound2)
+{
+    const T lo = std::min(bound1, bound2);
+    const T hi = std::max(bound1, bound2);
+    return std::max(lo, std::min(v, hi));
+}
+
+/// Largest absolute coordinate of a point
+template <typename T>
+T maxAbsCoordinate(const V2d<T>& p)
+{
+    return std::max(std::abs(p.x), std::abs(p.y));
+}
+
+} // namespace detail
+
+template <typename T>
+V2d<T> intersectionPosition(
+    const V2d<T>& p1,
+    const V2d<T>& p2,
+    const V2d<T>& p3,
+    const V2d<T>& p4)
+{
+    using namespace predicates::adaptive;
+    using detail::clampBetween;
+    using detail::lerp;
+    const T a34 = orient2d(p3.x, p3.y, p4.x, p4.y, p1.x, p1.y);
+    const T b34 = orient2d(p4.x, p4.y, p3.x, p3.y, p2.x, p2.y);
+    const T a12 = orient2d(p1.x, p1.y, p2.x, p2.y, p3.x, p3.y);
+    const T b12 = orient2d(p2.x, p2.y, p1.x, p1.y, p4.x, p4.y);
+    const T t12 = a34 / (a34 + b34);
+    const T t34 = a12 / (a12 + b12);
+    T x = std::abs(p1.x - p2.x) < std::abs(p3.x - p4.x)
+              ? lerp(p1.x, p2.x, t12)
+              : lerp(p3.x, p4.x, t34);
+    T y = std::abs(p1.y - p2.y) < std::abs(p3.y - p4.y)
+              ? lerp(p1.y, p2.y, t12)
+              : lerp(p3.y, p4.y, t34);
+    x = clampBetween(clampBetween(x, p1.x, p2.x), p3.x, p4.x);
+    y = clampBetween(clampBetween(y, p1.y, p2.y), p3.y, p4.y);
+    return V2d<T>::make(x, y);
+}
+
+template <typename T>
+bool isWithinRoundingError(const V2d<T>& p, const V2d<T>& a, const V2d<T>& b)
+{
+    using namespace predicates::adaptive;
+    using detail::maxAbsCoordinate;
+    const T m = std::max(
+        maxAbsCoordinate(p),
+        std::max(maxAbsCoordinate(a), maxAbsCoordinate(b)));
+    const T tolerance = T(16) * std::numeric_limits<T>::epsilon() * m;
+    const T area2 = orient2d(a.x, a.y, b.x, b.y, p.x, p.y);
+    return area2 * area2 <= tolerance * tolerance * distanceSquared(a, b);
+}
+
 } // namespace CDT
@@ -0,0 +1,382 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+/**
+ * @file
+ * Flat open-addressing hash set and hash map
+ */
+
+#ifndef CDT_FLATHASHTABLE_H
+#define CDT_FLATHASHTABLE_H
+
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace CDT
+{
+
+/**
+ * Mix bits of a hash value so that all bits of the input affect the low bits
+ * used for selecting a hash table slot (finalizer of MurmurHash3)
+ */
+inline std::size_t mixHash(unsigned long long h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<std::size_t>(h);
+}
+
+/// Bits of a floating point number for hashing: equal numbers hash equally
+template <typename T>
+unsigned long long floatBits(T x)
+{
+    if(x == T(0))
+        x = T(0); // -0 and +0 are equal
+    unsigned long long bits(0);
+    std::memcpy(&bits, &x, sizeof(x) < sizeof(bits) ? sizeof(x) : sizeof(bits));
+    return bits;
+}
+
+namespace detail
+{
+
+/// Key of a hash set element is the element itself
+template <typename T>
+struct SetElementKey
+{
+    static const T& get(const T& value)
+    {
+        return value;
+    }
+};
+
+/// Key of a hash map element is the first element of the pair
+template <typename TKey, typename TValue>
+struct MapElementKey
+{
+    static const TKey& get(const std::pair<TKey, TValue>& value)
+    {
+        return value.first;
+    }
+};
+
+/**
+ * Open-addressing hash table with linear probing
+ *
+ * Elements are stored densely in a vector in insertion order, probed slots
+ * only store element indices. There are no per-element allocations,
+ * iteration is a linear scan, and keys don't need a default constructor.
+ * Erasing moves the last element to the erased position (invalidates
+ * iterators) and uses backward-shift deletion: no tombstones are needed.
+ */
+template <typename TElement, typename TKey, typename TGetKey, typename THash>
+class FlatHashTable
+{
+public:
+    typedef TKey key_type;                ///< key type
+    typedef TElement value_type;          ///< element type
+    typedef std::size_t size_type;        ///< size type
+    typedef std::vector<TElement> Values; ///< storage of elements
+    typedef typename Values::const_iterator const_iterator; ///< iterator
+
+    /// Constructor
+    FlatHashTable()
+        : m_slotMask(0)
+    {}
+    /// Range constructor
+    template <typename TIter>
+    FlatHashTable(TIter first, TIter last)
+        : m_slotMask(0)
+    {
+        insert(first, last);
+    }
+    /// Begin of elements range
+    const_iterator begin() const
+    {
+        return m_values.begin();
+    }
+    /// End of elements range
+    const_iterator end() const
+    {
+        return m_values.end();
+    }
+    /// Number of elements
+    size_type size() const
+    {
+        return m_values.size();
+    }
+    /// If there are no elements
+    bool empty() const
+    {
+        return m_values.empty();
+    }
+    /// Remove all elements
+    void clear()
+    {
+        m_values.clear();
+        m_slots.clear();
+        m_slotMask = 0;
+    }
+    /// Reserve space for at least n elements without re-hashing
+    void reserve(const size_type n)
+    {
+        m_values.reserve(n);
+        if(2 * n > m_slots.size())
+            rehash(2 * n);
+    }
+    /// Swap contents with other table
+    void swap(FlatHashTable& other)
+    {
+        m_values.swap(other.m_values);
+        m_slots.swap(other.m_slots);
+        std::swap(m_slotMask, other.m_slotMask);
+    }
+    /// Find element with a key or end()
+    const_iterator find(const TKey& key) const
+    {
+        return m_values.begin() + findIndex(key);
+    }
+    /// Number of elements with a key: 0 or 1
+    size_type count(const TKey& key) const
+    {
+        return findIndex(key) == m_values.size() ? 0 : 1;
+    }
+    /// Insert range of elements
+    template <typename TIter>
+    void insert(TIter first, TIter last)
+    {
+        for(; first != last; ++first)
+            insertIndex(*first);
+    }
+    /// Erase element with a key, returns number of erased elements
+    size_type erase(const TKey& key)
+    {
+        if(m_values.empty())
+            return 0;
+        size_type iSlot = slotOf(key);
+        for(; m_slots[iSlot]; iSlot = (iSlot + 1) & m_slotMask)
+        {
+            if(TGetKey::get(m_values[m_slots[iSlot] - 1]) == key)
+                break;
+        }
+        if(!m_slots[iSlot])
+            return 0;
+        const size_type iErased = m_slots[iSlot] - 1;
+        // backward-shift deletion: move back elements displaced by probing
+        size_type iHole = iSlot;
+        for(size_type i = (iHole + 1) & m_slotMask; m_slots[i];
+            i = (i + 1) & m_slotMask)
+        {
+            const size_type iHome =
+                slotOf(TGetKey::get(m_values[m_slots[i] - 1]));
+            if(((i - iHome) & m_slotMask) >= ((i - iHole) & m_slotMask))
+            {
+                m_slots[iHole] = m_slots[i];
+                iHole = i;
+            }
+        }
+        m_slots[iHole] = 0;
+        // keep elements dense: last element takes place of erased one
+        const size_type iLast = m_values.size() - 1;
+        if(iErased != iLast)
+        {
+            size_type i = slotOf(TGetKey::get(m_values[iLast]));
+            while(m_slots[i] != iLast + 1)
+                i = (i + 1) & m_slotMask;
+            m_slots[i] = iErased + 1;
+            m_values[iErased] = m_values[iLast];
+        }
+        m_values.pop_back();
+        return 1;
+    }
+    /// Erase element at position
+    void erase(const const_iterator it)
+    {
+        const TKey key = TGetKey::get(*it);
+        erase(key);
+    }
+
+protected:
+    /// Index of element with a key or size() if not found
+    size_type findIndex(const TKey& key) const
+    {
+        if(m_values.empty())
+            return m_values.size();
+        for(size_type i = slotOf(key); m_slots[i]; i = (i + 1) & m_slotMask)
+        {
+            const size_type iValue = m_slots[i] - 1;
+            if(TGetKey::get(m_values[iValue]) == key)
+                return iValue;
+        }
+        return m_values.size();
+    }
+    /// Insert element if its key is not present, returns element's index and
+    /// if element was inserted
+    std::pair<size_type, bool> insertIndex(const TElement& value)
+    {
+        // keep load factor at most 1/2
+        if(2 * (m_values.size() + 1) > m_slots.size())
+            rehash(2 * m_slots.size());
+        const TKey& key = TGetKey::get(value);
+        size_type i = slotOf(key);
+        for(; m_slots[i]; i = (i + 1) & m_slotMask)
+        {
+            const size_type iValue = m_slots[i] - 1;
+            if(TGetKey::get(m_values[iValue]) == key)
+                return std::make_pair(iValue, false);
+        }
+        m_values.push_back(value);
+        m_slots[i] = m_values.size();
+        return std::make_pair(m_values.size() - 1, true);
+    }
+
+    Values m_values; ///< elements in insertion order
+
+private:
+    /// Home slot of a key
+    size_type slotOf(const TKey& key) const
+    {
+        return THash()(key) & m_slotMask;
+    }
+    /// Re-distribute elements into at least given number of slots
+    void rehash(const size_type minSlots)
+    {
+        size_type nSlots = 16;
+        while(nSlots < minSlots)
+            nSlots *= 2;
+        m_slots.assign(nSlots, 0);
+        m_slotMask = nSlots - 1;
+        for(size_type iValue = 0; iValue < m_values.size(); ++iValue)
+        {
+            size_type i = slotOf(TGetKey::get(m_values[iValue]));
+            while(m_slots[i])
+                i = (i + 1) & m_slotMask;
+            m_slots[i] = iValue + 1;
+        }
+    }
+
+    std::vector<size_type> m_slots; ///< element index + 1, 0 if slot is empty
+    size_type m_slotMask;           ///< number of slots - 1
+};
+
+} // namespace detail
+
+/**
+ * Flat open-addressing hash set
+ *
+ * Subset of std::unordered_set interface. Differences: elements are iterated
+ * in insertion order and erasing an element invalidates iterators.
+ * @tparam TKey element type
+ * @tparam THash hasher with well-mixed low bits (see @ref mixHash)
+ */
+template <typename TKey, typename THash>
+class FlatHashSet
+    : public detail::
+          FlatHashTable<TKey, TKey, detail::SetElementKey<TKey>, THash>
+{
+    typedef detail::
+        FlatHashTable<TKey, TKey, detail::SetElementKey<TKey>, THash>
+            Base;
+
+public:
+    typedef typename Base::const_iterator iterator; ///< elements are immutable
+
+    /// Constructor
+    FlatHashSet()
+        : Base()
+    {}
+    /// Range constructor
+    template <typename TIter>
+    FlatHashSet(TIter first, TIter last)
+        : Base(first, last)
+    {}
+    /// Insert element, returns its position and if it was inserted
+    std::pair<iterator, bool> insert(const TKey& key)
+    {
+        const std::pair<std::size_t, bool> res = Base::insertIndex(key);
+        return std::make_pair(this->m_values.begin() + res.first, res.second);
+    }
+    using Base::insert;
+};
+
+/**
+ * Flat open-addressing hash map
+ *
+ * Subset of std::unordered_map interface. Differences: elements are
+ * std::pair<TKey, TValue> iterated in insertion order (key must not be
+ * modified through iterators) and erasing an element invalidates iterators.
+ * @tparam TKey key type
+ * @tparam TValue mapped value type
+ * @tparam THash hasher of keys with well-mixed low bits (see @ref mixHash)
+ */
+template <typename TKey, typename TValue, typename THash>
+class FlatHashMap
+    : public detail::FlatHashTable<
+          std::pair<TKey, TValue>,
+          TKey,
+          detail::MapElementKey<TKey, TValue>,
+          THash>
+{
+    typedef detail::FlatHashTable<
+        std::pair<TKey, TValue>,
+        TKey,
+        detail::MapElementKey<TKey, TValue>,
+        THash>
+        Base;
+
+public:
+    typedef TValue mapped_type;                      ///< mapped value type
+    typedef typename Base::Values::iterator iterator; ///< iterator
+
+    /// Constructor
+    FlatHashMap()
+        : Base()
+    {}
+    /// Range constructor
+    template <typename TIter>
+    FlatHashMap(TIter first, TIter last)
+        : Base(first, last)
+    {}
+    using Base::begin;
+    using Base::end;
+    using Base::find;
+    using Base::insert;
+    /// Begin of elements range
+    iterator begin()
+    {
+        return this->m_values.begin();
+    }
+    /// End of elements range
+    iterator end()
+    {
+        return this->m_values.end();
+    }
+    /// Find element with a key or end()
+    iterator find(const TKey& key)
+    {
+        return this->m_values.begin() + Base::findIndex(key);
+    }
+    /// Insert element, returns its position and if it was inserted
+    std::pair<iterator, bool> insert(const std::pair<TKey, TValue>& value)
+    {
+        const std::pair<std::size_t, bool> res = Base::insertIndex(value);
+        return std::make_pair(this->m_values.begin() + res.first, res.second);
+    }
+    /// Access value of a key, inserting default value if key is not present
+    TValue& operator[](const TKey& key)
+    {
+        const std::size_t i =
+            Base::insertIndex(std::make_pair(key, TValue())).first;
+        return this->m_values[i].second;
+    }
+};
+
+} // namespace CDT
+
+#endif
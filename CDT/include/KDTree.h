@@ -9,7 +9,9 @@
 
 #include "CDTUtils.h"
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <limits>
 
 namespace KDTree
@@ -27,8 +29,16 @@ struct NodeSplitDirection
 /// Simple tree structure with alternating half splitting nodes
 /// @details Simple tree structure
 ///          - Tree to incrementally add points to the structure.
-///          - Get the nearest point to a given input.
+///          - Points can be removed or relocated; sparse leaves are merged.
+///          - Skewed trees (e.g., after far outliers extended the root box) are
+///            automatically rebuilt with median splits; rebuild can also be
+///            triggered on demand with @ref rebalance.
+///          - Get the nearest point to a given input: exactly or
+///            approximately (limiting the number of visited leaves).
 ///          - Does not check for duplicates, expect unique points.
+///          - Thread-safety: concurrent nearest queries are safe when each
+///            thread provides its own stack (see @ref NearestTasksStack).
+///            Modifications require exclusive access.
 /// @tparam TCoordType type used for storing point coordinate.
 /// @tparam NumVerticesInLeaf The number of points per leaf.
 /// @tparam InitialStackDepth initial size of stack depth for nearest query.
@@ -57,8 +67,10 @@ public:
     {
         children_type children; ///< two children if not leaf; {0,0} if leaf
         point_data_vec data;    ///< points' data if leaf
+        coord_type split;       ///< split coordinate if not leaf
         /// Create empty leaf
         Node()
+            : split(0)
         {
             setChildren(0, 0);
             data.reserve(NumVerticesInLeaf);
@@ -76,6 +88,34 @@ public:
         }
     };
 
+    /// Traversal task of the nearest-neighbor query
+    struct NearestTask
+    {
+        node_index node;              ///< node to visit
+        point_type min, max;          ///< node's box
+        NodeSplitDirection::Enum dir; ///< node's split direction
+        coord_type distSq; ///< squared distance to node's box from query point
+        /// Create uninitialized task
+        NearestTask()
+        {}
+        /// Create task for visiting a node with a given box
+        NearestTask(
+            const node_index node,
+            const point_type& min,
+            const point_type& max,
+            const NodeSplitDirection::Enum dir,
+            const coord_type distSq)
+            : node(node)
+            , min(min)
+            , max(max)
+            , dir(dir)
+            , distSq(distSq)
+        {}
+    };
+
+    /// Stack of tasks used for traversing the tree in the nearest query
+    typedef std::vector<NearestTask> NearestTasksStack;
+
     /// Default constructor
     KDTree()
         : m_rootDir(NodeSplitDirection::X)
@@ -86,96 +126,161 @@ public:
               std::numeric_limits<coord_type>::max(),
               std::numeric_limits<coord_type>::max()))
         , m_isRootBoxInitialized(false)
+        , m_size(0)
+        , m_nModifications(0)
         , m_tasksStack(InitialStackDepth, NearestTask())
     {
         m_root = addNewNode();
     }
 
+    /// Number of points in the tree
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
     /// Insert a point into kd-tree
     /// @note external point-buffer is used to reduce kd-tree's memory footprint
+    /// @note triggers @ref rebalance if tree became too deep
     /// @param iPoint index of point in external point-buffer
     /// @param points external point-buffer
     void
     insert(const point_index& iPoint, const std::vector<point_type>& points)
     {
-        // if point is outside root, extend tree by adding new roots
-        const point_type& pos = points[iPoint];
-        while(!isInsideBox(pos, m_min, m_max))
-        {
-            extendTree(pos);
-        }
-        // now insert the point into the tree
-        node_index node = m_root;
-        point_type min = m_min;
-        point_type max = m_max;
-        NodeSplitDirection::Enum dir = m_rootDir;
+        const std::size_t depth = insertPoint(iPoint, points);
+        ++m_size;
+        ++m_nModifications;
+        if(isTooDeep(depth) && m_nModifications >= m_size / 2)
+            rebalance(points);
+    }
 
-        // below: initialized only to suppress warnings
-        NodeSplitDirection::Enum newDir(NodeSplitDirection::X);
-        coord_type mid(0);
-        point_type newMin, newMax;
-        while(true)
+    /// Remove a point from kd-tree
+    /// @note point's position in point-buffer must be the same as when the
+    /// point was inserted; use @ref relocate for moved points
+    /// @param iPoint index of point in external point-buffer
+    /// @param points external point-buffer
+    /// @returns true if point was found and removed
+    bool
+    remove(const point_index& iPoint, const std::vector<point_type>& points)
+    {
+        return removePoint(iPoint, points[iPoint]);
+    }
+
+    /// Update position of a point that was moved in point-buffer
+    /// @param iPoint index of point in external point-buffer
+    /// @param oldPos point position when it was inserted
+    /// @param points external point-buffer containing new point position
+    /// @returns true if point was found and relocated; point is not
+    /// inserted if it was not found at the old position
+    bool relocate(
+        const point_index& iPoint,
+        const point_type& oldPos,
+        const std::vector<point_type>& points)
+    {
+        if(!removePoint(iPoint, oldPos))
+            return false;
+        insert(iPoint, points);
+        return true;
+    }
+
+    /// Rebuild the tree with median splits and a tight root box
+    /// @details Removes the chains of nodes created by extending the root box
+    /// towards far outliers and deep branches of clustered points.
+    /// Complexity is O(N*log(N)).
+    /// @param points external point-buffer
+    void rebalance(const std::vector<point_type>& points)
+    {
+        point_data_vec allPoints;
+        allPoints.reserve(m_size);
+        node_index_vec stack(1, m_root);
+        while(!stack.empty())
         {
-            if(m_nodes[node].isLeaf())
-            {
-                // add point if capacity is not reached
-                point_data_vec& pd = m_nodes[node].data;
-                if(pd.size() < NumVerticesInLeaf)
-                {
-                    pd.push_back(iPoint);
-                    return;
-                }
-                // initialize bbox first time the root capacity is reached
-                if(!m_isRootBoxInitialized)
-                {
-                    initializeRootBox(points);
-                    min = m_min;
-                    max = m_max;
-                }
-                // split a full leaf node
-                calcSplitInfo(min, max, dir, mid, newDir, newMin, newMax);
-                const node_index c1 = addNewNode(), c2 = addNewNode();
-                Node& n = m_nodes[node];
-                n.setChildren(c1, c2);
-                point_data_vec& c1data = m_nodes[c1].data;
-                point_data_vec& c2data = m_nodes[c2].data;
-                // move node's points to children
-                for(pd_cit it = n.data.begin(); it != n.data.end(); ++it)
-                {
-                    whichChild(points[*it], mid, dir) == 0
-                        ? c1data.push_back(*it)
-                        : c2data.push_back(*it);
-                }
-                n.data = point_data_vec();
-            }
-            else
+            const Node& n = m_nodes[stack.back()];
+            stack.pop_back();
+            if(n.isLeaf())
             {
-                calcSplitInfo(min, max, dir, mid, newDir, newMin, newMax);
+                allPoints.insert(allPoints.end(), n.data.begin(), n.data.end());
+                continue;
             }
-            // add the point to a child
-            const std::size_t iChild = whichChild(points[iPoint], mid, dir);
-            iChild == 0 ? max = newMax : min = newMin;
-            node = m_nodes[node].children[iChild];
-            dir = newDir;
+            stack.push_back(n.children[0]);
+            stack.push_back(n.children[1]);
+        }
+        m_nodes.clear();
+        m_freeNodes.clear();
+        m_nModifications = 0;
+        m_size = allPoints.size();
+        if(allPoints.size() <= NumVerticesInLeaf)
+        {
+            m_root = addNewNode();
+            m_nodes[m_root].data = allPoints;
+            m_isRootBoxInitialized = false;
+            m_min = point_type::make(
+                -std::numeric_limits<coord_type>::max(),
+                -std::numeric_limits<coord_type>::max());
+            m_max = point_type::make(
+                std::numeric_limits<coord_type>::max(),
+                std::numeric_limits<coord_type>::max());
+            return;
         }
+        m_min = m_max = points[allPoints.front()];
+        for(pd_cit it = allPoints.begin(); it != allPoints.end(); ++it)
+            expandBox(points[*it], m_min, m_max);
+        m_isRootBoxInitialized = true;
+        m_rootDir = m_max.x - m_min.x >= m_max.y - m_min.y
+                        ? NodeSplitDirection::X
+                        : NodeSplitDirection::Y;
+        m_root = buildSubtree(
+            allPoints.begin(), allPoints.end(), m_rootDir, false, points);
     }
 
     /// Query kd-tree for a nearest neighbor point
     /// @note external point-buffer is used to reduce kd-tree's memory footprint
+    /// @note uses traversal stack stored in the tree: not re-entrant, use
+    /// overload with a caller-provided stack for concurrent queries
     /// @param point query point position
     /// @param points external point-buffer
+    /// @param maxVisitedLeaves if not zero, search is approximate: it stops
+    /// after visiting given number of non-empty leaves and returns the nearest
+    /// point found so far. Tree is traversed depth-first descending into the
+    /// child containing the query point first: only the first visited leaf
+    /// is guaranteed to contain the query point, following leaves are not
+    /// ordered by distance.
     value_type nearest(
         const point_type& point,
-        const std::vector<point_type>& points) const
+        const std::vector<point_type>& points,
+        const std::size_t maxVisitedLeaves = 0) const
     {
+        return nearest(point, points, m_tasksStack, maxVisitedLeaves);
+    }
+
+    /// Query kd-tree for a nearest neighbor point using caller-provided stack
+    /// @details Does not modify the tree: concurrent queries from multiple
+    /// threads are safe as long as each thread provides its own stack and no
+    /// thread modifies the tree or the point-buffer at the same time.
+    /// @note external point-buffer is used to reduce kd-tree's memory footprint
+    /// @param point query point position
+    /// @param points external point-buffer
+    /// @param tasksStack traversal stack, grown when needed; re-use it between
+    /// queries to avoid re-allocations
+    /// @param maxVisitedLeaves if not zero, search is approximate: it stops
+    /// after visiting given number of non-empty leaves
+    value_type nearest(
+        const point_type& point,
+        const std::vector<point_type>& points,
+        NearestTasksStack& tasksStack,
+        const std::size_t maxVisitedLeaves = 0) const
+    {
+        if(tasksStack.size() < InitialStackDepth)
+            tasksStack.resize(InitialStackDepth);
         value_type out;
         int iTask = -1;
+        std::size_t nVisitedLeaves = 0;
         coord_type minDistSq = std::numeric_limits<coord_type>::max();
-        m_tasksStack[++iTask] =
-            NearestTask(m_root, m_min, m_max, m_rootDir, minDistSq);
+        tasksStack[++iTask] =
+            NearestTask(m_root, m_min, m_max, m_rootDir, coord_type(0));
         while(iTask != -1)
         {
-            const NearestTask t = m_tasksStack[iTask--];
+            const NearestTask t = tasksStack[iTask--];
             if(t.distSq > minDistSq)
                 continue;
             const Node& n = m_nodes[t.node];
@@ -192,10 +297,12 @@ public:
                         out.second = *it;
                     }
                 }
+                if(!n.data.empty() && ++nVisitedLeaves == maxVisitedLeaves)
+                    break;
             }
             else
             {
-                coord_type mid;
+                const coord_type mid = n.split;
                 NodeSplitDirection::Enum newDir;
                 point_type newMin, newMax;
                 calcSplitInfo(t.min, t.max, t.dir, mid, newDir, newMin, newMax);
@@ -203,28 +310,29 @@ public:
                 const coord_type distToMid = t.dir == NodeSplitDirection::X
                                                  ? (point.x - mid)
                                                  : (point.y - mid);
-                const coord_type toMidSq = distToMid * distToMid;
+                const coord_type toMidSq =
+                    std::max(t.distSq, distToMid * distToMid);
 
                 const std::size_t iChild = whichChild(point, mid, t.dir);
-                if(iTask + 2 >= static_cast<int>(m_tasksStack.size()))
+                if(iTask + 2 >= static_cast<int>(tasksStack.size()))
                 {
-                    m_tasksStack.resize(
-                        m_tasksStack.size() + StackDepthIncrement);
+                    tasksStack.resize(tasksStack.size() + StackDepthIncrement);
                 }
                 // node containing point should end up on top of the stack
+                // (it is at least as close to the point as the parent node)
                 if(iChild == 0)
                 {
-                    m_tasksStack[++iTask] = NearestTask(
+                    tasksStack[++iTask] = NearestTask(
                         n.children[1], newMin, t.max, newDir, toMidSq);
-                    m_tasksStack[++iTask] = NearestTask(
-                        n.children[0], t.min, newMax, newDir, toMidSq);
+                    tasksStack[++iTask] = NearestTask(
+                        n.children[0], t.min, newMax, newDir, t.distSq);
                 }
                 else
                 {
-                    m_tasksStack[++iTask] = NearestTask(
+                    tasksStack[++iTask] = NearestTask(
                         n.children[0], t.min, newMax, newDir, toMidSq);
-                    m_tasksStack[++iTask] = NearestTask(
-                        n.children[1], newMin, t.max, newDir, toMidSq);
+                    tasksStack[++iTask] = NearestTask(
+                        n.children[1], newMin, t.max, newDir, t.distSq);
                 }
             }
         }
@@ -232,14 +340,252 @@ public:
     }
 
 private:
+    typedef std::vector<node_index> node_index_vec;
+    typedef point_data_vec::iterator pd_it;
+
+    /// Compare points by coordinate in a split direction
+    struct CoordLess
+    {
+        CoordLess(
+            const NodeSplitDirection::Enum dir_,
+            const std::vector<point_type>& points_)
+            : dir(dir_)
+            , points(&points_)
+        {}
+        coord_type coord(const point_index& iPoint) const
+        {
+            const point_type& p = (*points)[iPoint];
+            return dir == NodeSplitDirection::X ? p.x : p.y;
+        }
+        bool operator()(const point_index& i1, const point_index& i2) const
+        {
+            return coord(i1) < coord(i2);
+        }
+        NodeSplitDirection::Enum dir;
+        const std::vector<point_type>* points;
+    };
+
+    /// Test if point's coordinate is below (or not above) a split coordinate
+    struct CoordBelow
+    {
+        CoordBelow(
+            const coord_type split_,
+            const bool isStrict_,
+            const CoordLess& less_)
+            : split(split_)
+            , isStrict(isStrict_)
+            , less(less_)
+        {}
+        bool operator()(const point_index& iPoint) const
+        {
+            const coord_type c = less.coord(iPoint);
+            return isStrict ? c < split : !(c > split);
+        }
+        coord_type split;
+        bool isStrict;
+        CoordLess less;
+    };
+
+    /// Insert a point into kd-tree
+    /// @returns depth of the leaf the point was added to
+    std::size_t insertPoint(
+        const point_index& iPoint,
+        const std::vector<point_type>& points)
+    {
+        // if point is outside root, extend tree by adding new roots
+        const point_type& pos = points[iPoint];
+        while(!isInsideBox(pos, m_min, m_max))
+        {
+            extendTree(pos);
+        }
+        // now insert the point into the tree
+        node_index node = m_root;
+        point_type min = m_min;
+        point_type max = m_max;
+        NodeSplitDirection::Enum dir = m_rootDir;
+        std::size_t depth = 0;
+
+        // below: initialized only to suppress warnings
+        NodeSplitDirection::Enum newDir(NodeSplitDirection::X);
+        point_type newMin, newMax;
+        while(true)
+        {
+            if(m_nodes[node].isLeaf())
+            {
+                // add point if capacity is not reached
+                point_data_vec& pd = m_nodes[node].data;
+                if(pd.size() < NumVerticesInLeaf)
+                {
+                    pd.push_back(iPoint);
+                    return depth;
+                }
+                // initialize bbox first time the root capacity is reached
+                if(!m_isRootBoxInitialized)
+                {
+                    initializeRootBox(iPoint, points);
+                    min = m_min;
+                    max = m_max;
+                }
+                // split a full leaf node
+                const coord_type mid = midSplit(min, max, dir);
+                const node_index c1 = addNewNode(), c2 = addNewNode();
+                Node& n = m_nodes[node];
+                n.setChildren(c1, c2);
+                n.split = mid;
+                point_data_vec& c1data = m_nodes[c1].data;
+                point_data_vec& c2data = m_nodes[c2].data;
+                // move node's points to children
+                for(pd_cit it = n.data.begin(); it != n.data.end(); ++it)
+                {
+                    whichChild(points[*it], mid, dir) == 0
+                        ? c1data.push_back(*it)
+                        : c2data.push_back(*it);
+                }
+                n.data = point_data_vec();
+            }
+            const coord_type mid = m_nodes[node].split;
+            calcSplitInfo(min, max, dir, mid, newDir, newMin, newMax);
+            // add the point to a child
+            const std::size_t iChild = whichChild(points[iPoint], mid, dir);
+            iChild == 0 ? max = newMax : min = newMin;
+            node = m_nodes[node].children[iChild];
+            dir = newDir;
+            ++depth;
+        }
+    }
+
+    /// Remove a point located at a given position and merge sparse leaves
+    /// @returns true if point was found and removed
+    bool removePoint(const point_index& iPoint, const point_type& pos)
+    {
+        if(!isInsideBox(pos, m_min, m_max))
+            return false;
+        node_index_vec path;
+        node_index node = m_root;
+        NodeSplitDirection::Enum dir = m_rootDir;
+        while(!m_nodes[node].isLeaf())
+        {
+            path.push_back(node);
+            const Node& n = m_nodes[node];
+            node = n.children[whichChild(pos, n.split, dir)];
+            dir = dir == NodeSplitDirection::X ? NodeSplitDirection::Y
+                                               : NodeSplitDirection::X;
+        }
+        point_data_vec& pd = m_nodes[node].data;
+        const pd_it it = std::find(pd.begin(), pd.end(), iPoint);
+        if(it == pd.end())
+            return false;
+        pd.erase(it);
+        --m_size;
+        ++m_nModifications;
+        // merge children into parent while they fit into a single leaf
+        for(; !path.empty(); path.pop_back())
+        {
+            const node_index c1 = m_nodes[path.back()].children[0];
+            const node_index c2 = m_nodes[path.back()].children[1];
+            const Node& n1 = m_nodes[c1];
+            const Node& n2 = m_nodes[c2];
+            if(!n1.isLeaf() || !n2.isLeaf() ||
+               n1.data.size() + n2.data.size() > NumVerticesInLeaf)
+            {
+                break;
+            }
+            point_data_vec& merged = m_nodes[path.back()].data;
+            merged.reserve(NumVerticesInLeaf);
+            merged.insert(merged.end(), n1.data.begin(), n1.data.end());
+            merged.insert(merged.end(), n2.data.begin(), n2.data.end());
+            m_nodes[path.back()].setChildren(0, 0);
+            freeNode(c1);
+            freeNode(c2);
+        }
+        return true;
+    }
+
+    /// Build a balanced subtree with median splits
+    /// @param first beginning of the range of subtree's points
+    /// @param last end of the range of subtree's points
+    /// @param dir split direction of subtree's root
+    /// @param isPrevSplitEmpty if split of the parent node failed to
+    /// separate points (all points have the same coordinate)
+    /// @param points external point-buffer
+    /// @returns index of subtree's root node
+    node_index buildSubtree(
+        const pd_it first,
+        const pd_it last,
+        const NodeSplitDirection::Enum dir,
+        const bool isPrevSplitEmpty,
+        const std::vector<point_type>& points)
+    {
+        const node_index node = addNewNode();
+        const std::size_t nPoints = std::distance(first, last);
+        if(nPoints <= NumVerticesInLeaf)
+        {
+            m_nodes[node].data.assign(first, last);
+            return node;
+        }
+        const CoordLess less(dir, points);
+        const pd_it median = first + (nPoints - 1) / 2;
+        std::nth_element(first, median, last, less);
+        coord_type split = less.coord(*median);
+        // points not above split go to the first child
+        pd_it mid = std::partition(first, last, CoordBelow(split, false, less));
+        if(mid == last) // median is the max: move max coordinates to 2nd child
+        {
+            mid = std::partition(first, last, CoordBelow(split, true, less));
+            if(mid != first)
+                split = less.coord(*std::max_element(first, mid, less));
+            else // all points have the same coordinate
+                mid = last;
+        }
+        const bool isSplitEmpty = mid == last;
+        if(isSplitEmpty && isPrevSplitEmpty) // all points are the same
+        {
+            m_nodes[node].data.assign(first, last);
+            return node;
+        }
+        const NodeSplitDirection::Enum newDir = dir == NodeSplitDirection::X
+                                                    ? NodeSplitDirection::Y
+                                                    : NodeSplitDirection::X;
+        const node_index c1 =
+            buildSubtree(first, mid, newDir, isSplitEmpty, points);
+        const node_index c2 =
+            buildSubtree(mid, last, newDir, isSplitEmpty, points);
+        m_nodes[node].setChildren(c1, c2);
+        m_nodes[node].split = split;
+        return node;
+    }
+
+    /// Check if leaf depth is too large compared to a balanced tree depth
+    bool isTooDeep(const std::size_t depth) const
+    {
+        std::size_t balancedDepth = 1;
+        for(std::size_t n = m_size / NumVerticesInLeaf; n > 0; n /= 2)
+            ++balancedDepth;
+        return depth > 2 * balancedDepth + 4;
+    }
+
     /// Add a new node and return it's index in nodes buffer
     node_index addNewNode()
     {
+        if(!m_freeNodes.empty())
+        {
+            const node_index reused = m_freeNodes.back();
+            m_freeNodes.pop_back();
+            m_nodes[reused] = Node();
+            return reused;
+        }
         const node_index newNodeIndex = m_nodes.size();
         m_nodes.push_back(Node());
         return newNodeIndex;
     }
 
+    /// Release node for re-use
+    void freeNode(const node_index node)
+    {
+        m_nodes[node].data = point_data_vec();
+        m_freeNodes.push_back(node);
+    }
+
     /// Test which child point belongs to after the split
     /// @returns 0 if first child, 1 if second child
     std::size_t whichChild(
@@ -251,12 +597,22 @@ private:
             dir == NodeSplitDirection::X ? point.x > split : point.y > split);
     }
 
-    /// Calculate split location, direction, and children boxes
+    /// Calculate split location in the middle of the box
+    static coord_type midSplit(
+        const point_type& min,
+        const point_type& max,
+        const NodeSplitDirection::Enum dir)
+    {
+        return dir == NodeSplitDirection::X ? (min.x + max.x) / coord_type(2)
+                                            : (min.y + max.y) / coord_type(2);
+    }
+
+    /// Calculate split direction and children boxes
     static void calcSplitInfo(
         const point_type& min,
         const point_type& max,
         const NodeSplitDirection::Enum dir,
-        coord_type& midOut,
+        const coord_type mid,
         NodeSplitDirection::Enum& newDirOut,
         point_type& newMinOut,
         point_type& newMaxOut)
@@ -266,16 +622,14 @@ private:
         switch(dir)
         {
         case NodeSplitDirection::X:
-            midOut = (min.x + max.x) / coord_type(2);
             newDirOut = NodeSplitDirection::Y;
-            newMinOut.x = midOut;
-            newMaxOut.x = midOut;
+            newMinOut.x = mid;
+            newMaxOut.x = mid;
             return;
         case NodeSplitDirection::Y:
-            midOut = (min.y + max.y) / coord_type(2);
             newDirOut = NodeSplitDirection::X;
-            newMinOut.y = midOut;
-            newMaxOut.y = midOut;
+            newMinOut.y = mid;
+            newMaxOut.y = mid;
             return;
         }
     }
@@ -289,50 +643,75 @@ private:
         return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y;
     }
 
+    /// Expand a box to contain a point
+    static void expandBox(const point_type& p, point_type& min, point_type& max)
+    {
+        min = point_type::make(std::min(min.x, p.x), std::min(min.y, p.y));
+        max = point_type::make(std::max(max.x, p.x), std::max(max.y, p.y));
+    }
+
     /// Extend a tree by creating new root with old root and a new node as
     /// children
+    /// @details Root box is grown at least twice in the new root's direction
+    /// and far enough to contain the point in one step: far outliers do not
+    /// create long chains of nodes.
     void extendTree(const point_type& point)
     {
         const node_index newRoot = addNewNode();
         const node_index newLeaf = addNewNode();
+        Node& n = m_nodes[newRoot];
         switch(m_rootDir)
         {
         case NodeSplitDirection::X:
             m_rootDir = NodeSplitDirection::Y;
-            point.y < m_min.y ? m_nodes[newRoot].setChildren(newLeaf, m_root)
-                              : m_nodes[newRoot].setChildren(m_root, newLeaf);
-            if(point.y < m_min.y)
-                m_min.y -= m_max.y - m_min.y;
-            else if(point.y > m_max.y)
-                m_max.y += m_max.y - m_min.y;
+            extendRange(point.y, newLeaf, n, m_min.y, m_max.y);
             break;
         case NodeSplitDirection::Y:
             m_rootDir = NodeSplitDirection::X;
-            point.x < m_min.x ? m_nodes[newRoot].setChildren(newLeaf, m_root)
-                              : m_nodes[newRoot].setChildren(m_root, newLeaf);
-            if(point.x < m_min.x)
-                m_min.x -= m_max.x - m_min.x;
-            else if(point.x > m_max.x)
-                m_max.x += m_max.x - m_min.x;
+            extendRange(point.x, newLeaf, n, m_min.x, m_max.x);
             break;
         }
         m_root = newRoot;
     }
 
-    /// Calculate root's box enclosing all root points
-    void initializeRootBox(const std::vector<point_type>& points)
+    /// Extend root range in one direction towards a coordinate
+    void extendRange(
+        const coord_type c,
+        const node_index newLeaf,
+        Node& newRoot,
+        coord_type& min,
+        coord_type& max)
+    {
+        const coord_type size = max - min;
+        if(c < min)
+        {
+            const coord_type delta = std::max(size, min - c);
+            // old root has to keep the points lying exactly on the boundary
+            coord_type split = min - delta / coord_type(2);
+            if(!(split < min))
+                split = c;
+            newRoot.setChildren(newLeaf, m_root);
+            newRoot.split = split;
+            min -= delta;
+        }
+        else
+        {
+            newRoot.setChildren(m_root, newLeaf);
+            newRoot.split = max;
+            max += std::max(size, c - max);
+        }
+    }
+
+    /// Calculate root's box enclosing all root points and the inserted point
+    void initializeRootBox(
+        const point_index& iPoint,
+        const std::vector<point_type>& points)
     {
         const point_data_vec& data = m_nodes[m_root].data;
-        m_min = points[data.front()];
+        m_min = points[iPoint];
         m_max = m_min;
         for(pd_cit it = data.begin(); it != data.end(); ++it)
-        {
-            const point_type& p = points[*it];
-            m_min = point_type::make(
-                std::min(m_min.x, p.x), std::min(m_min.y, p.y));
-            m_max = point_type::make(
-                std::max(m_max.x, p.x), std::max(m_max.y, p.y));
-        }
+            expandBox(points[*it], m_min, m_max);
         m_isRootBoxInitialized = true;
     }
 
@@ -343,31 +722,12 @@ private:
     point_type m_min;
     point_type m_max;
     bool m_isRootBoxInitialized;
+    std::size_t m_size;
+    std::size_t m_nModifications; // number of inserts/removals since rebuild
+    node_index_vec m_freeNodes;   // nodes released by merging leaves
 
-    // used for nearest query
-    struct NearestTask
-    {
-        node_index node;
-        point_type min, max;
-        NodeSplitDirection::Enum dir;
-        coord_type distSq;
-        NearestTask()
-        {}
-        NearestTask(
-            const node_index node,
-            const point_type& min,
-            const point_type& max,
-            const NodeSplitDirection::Enum dir,
-            const coord_type distSq)
-            : node(node)
-            , min(min)
-            , max(max)
-            , dir(dir)
-            , distSq(distSq)
-        {}
-    };
     // allocated in class (not in the 'nearest' method) for better performance
-    mutable std::vector<NearestTask> m_tasksStack;
+    mutable NearestTasksStack m_tasksStack;
 };
 
 } // namespace KDTree
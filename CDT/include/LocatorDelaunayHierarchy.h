@@ -0,0 +1,362 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+/**
+ * @file
+ * Delaunay hierarchy for locating near points
+ */
+
+#ifndef CDT_LOCATORDELAUNAYHIERARCHY_H
+#define CDT_LOCATORDELAUNAYHIERARCHY_H
+
+#include "CDT.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace CDT
+{
+
+namespace detail
+{
+
+/// Locator returning a start vertex that is set from outside
+template <typename TCoordType>
+class LocatorHint
+{
+public:
+    /// Constructor: @p hint points to the start vertex for all queries
+    explicit LocatorHint(const VertInd* hint = NULL)
+        : m_hint(hint)
+    {}
+    /// No-op: points are not stored
+    void addPoint(VertInd, const std::vector<V2d<TCoordType> >&)
+    {}
+    /// Returns current hint
+    VertInd nearPoint(
+        const V2d<TCoordType>&,
+        const std::vector<V2d<TCoordType> >&) const
+    {
+        return *m_hint;
+    }
+
+private:
+    const VertInd* m_hint;
+};
+
+} // namespace detail
+
+/**
+ * Delaunay hierarchy for locating near points
+ *
+ * Each added point is also inserted into coarser level with probability
+ * 1/@p Ratio (and so on up to @p MaxLevels levels). Each level is a Delaunay
+ * triangulation of its points. To locate a point the coarsest level is walked
+ * first, the nearest vertex of the found triangle is the start of the walk in
+ * the finer level, and so forth. Each walk visits expected O(1) triangles, so
+ * location takes expected O(log n) time regardless of points distribution.
+ * This makes the hierarchy robust for heavily clustered inputs, where a
+ * mid-split kd-tree degrades.
+ *
+ * Which points are promoted to coarser levels is a pseudo-random function of
+ * point index, so the result is deterministic.
+ *
+ * All points added to the locator should lie inside the bounding box of the
+ * first points (true for super-triangle and custom super-geometry vertices).
+ * Otherwise the levels are re-built with a larger box.
+ *
+ * @note Queries are const and use no shared scratch memory: concurrent
+ * queries are safe when no points are added at the same time.
+ * @note Copying the locator re-builds the levels.
+ * @tparam TCoordType type used for storing point coordinate.
+ * @tparam Ratio ratio between the numbers of points in adjacent levels
+ * @tparam MaxLevels maximum number of coarse levels
+ */
+template <typename TCoordType, size_t Ratio = 30, size_t MaxLevels = 5>
+class LocatorDelaunayHierarchy
+{
+    typedef detail::LocatorHint<TCoordType> LevelLocator;
+    typedef Triangulation<TCoordType, LevelLocator> LevelTriangulation;
+    /// Coarse level of the hierarchy
+    struct Level
+    {
+        /// Level's vertices: super-triangle, box corners, then points
+        LevelTriangulation cdt;
+        /// Vertex index in the finer level for each of level's points
+        std::vector<VertInd> toFiner;
+
+        explicit Level(const VertInd* hint)
+            : cdt(VertexInsertionOrder::AsProvided, LevelLocator(hint))
+        {}
+    };
+    /// Number of level vertices preceding points: super-triangle and corners
+    static const VertInd nLevelDummies = 7;
+
+public:
+    /// Constructor
+    LocatorDelaunayHierarchy()
+        : m_firstPoint(noVertex)
+        , m_hint(0)
+    {
+        const TCoordType max = std::numeric_limits<TCoordType>::max();
+        m_box.min = m_levelsBox.min = V2d<TCoordType>::make(max, max);
+        m_box.max = m_levelsBox.max = V2d<TCoordType>::make(-max, -max);
+    }
+    /// Copy constructor: re-builds the levels
+    LocatorDelaunayHierarchy(const LocatorDelaunayHierarchy& other)
+        : m_box(other.m_box)
+        , m_levelsBox(other.m_levelsBox)
+        , m_firstPoint(other.m_firstPoint)
+        , m_hint(0)
+    {
+        copyLevels(other.m_levels);
+    }
+    /// Copy assignment: re-builds the levels
+    LocatorDelaunayHierarchy& operator=(const LocatorDelaunayHierarchy& other)
+    {
+        if(this == &other)
+            return *this;
+        m_box = other.m_box;
+        m_levelsBox = other.m_levelsBox;
+        m_firstPoint = other.m_firstPoint;
+        copyLevels(other.m_levels);
+        return *this;
+    }
+    /// Add point to the hierarchy
+    void addPoint(const VertInd i, const std::vector<V2d<TCoordType> >& points)
+    {
+        const V2d<TCoordType>& pos = points[i];
+        if(m_firstPoint == noVertex)
+            m_firstPoint = i;
+        expandBox(m_box, pos);
+        std::size_t nLevels = randomLevel(i);
+        // box must have an area for the levels' super-triangles
+        if(m_box.min.x == m_box.max.x && m_box.min.y == m_box.max.y)
+            nLevels = 0;
+        if(nLevels == 0)
+            return;
+        if(!isStrictlyInside(m_levelsBox, pos))
+        {
+            m_levelsBox = inflatedBox(m_box);
+            std::vector<Level> oldLevels;
+            oldLevels.swap(m_levels);
+            copyLevels(oldLevels);
+        }
+        while(m_levels.size() < nLevels)
+            addLevel();
+        // find walk starts on each level
+        VertInd starts[MaxLevels];
+        VertInd iV(0);
+        for(std::size_t k = m_levels.size(); k-- > 0;)
+        {
+            if(k < nLevels)
+                starts[k] = iV;
+            iV = descend(k, iV, pos);
+        }
+        // insert into levels from fine to coarse
+        VertInd iFiner = i;
+        for(std::size_t k = 0; k < nLevels; ++k)
+        {
+            Level& l = m_levels[k];
+            const VertInd iNew(l.cdt.vertices.size());
+            m_hint = starts[k];
+            l.cdt.insertVertices(
+                &pos, &pos + 1, getX_V2d<TCoordType>, getY_V2d<TCoordType>);
+            l.toFiner.push_back(iFiner);
+            iFiner = iNew;
+        }
+    }
+    /// Find a point near to the given position
+    VertInd nearPoint(
+        const V2d<TCoordType>& pos,
+        const std::vector<V2d<TCoordType> >&) const
+    {
+        VertInd iV(0);
+        for(std::size_t k = m_levels.size(); k-- > 0;)
+            iV = descend(k, iV, pos);
+        return m_levels.empty() ? m_firstPoint : iV;
+    }
+
+private:
+    /**
+     * Find the level's point nearest to position and return its index in the
+     * finer level: walk to the triangle containing the position, then move
+     * greedily to closer neighbor vertices (finds the nearest point in
+     * Delaunay triangulations)
+     */
+    VertInd descend(
+        const std::size_t iLevel,
+        const VertInd start,
+        const V2d<TCoordType>& pos) const
+    {
+        const Level& l = m_levels[iLevel];
+        const Triangle& t = l.cdt.triangles[walk(l.cdt, start, pos)];
+        VertInd iNearest = noVertex;
+        TCoordType minDistSq = std::numeric_limits<TCoordType>::max();
+        for(Index i(0); i < Index(3); ++i)
+            updateNearest(l.cdt, t.vertices[i], pos, iNearest, minDistSq);
+        // fall back to first vertex if triangle has only dummy vertices
+        if(iNearest == noVertex)
+            return iLevel == 0 ? m_firstPoint : VertInd(0);
+        for(VertInd iCurr = noVertex; iCurr != iNearest;)
+        {
+            iCurr = iNearest;
+            const TriIndVec& vTris = l.cdt.vertTris[iCurr];
+            typedef TriIndVec::const_iterator TriIndCit;
+            for(TriIndCit it = vTris.begin(); it != vTris.end(); ++it)
+            {
+                const Triangle& vt = l.cdt.triangles[*it];
+                for(Index i(0); i < Index(3); ++i)
+                {
+                    updateNearest(
+                        l.cdt, vt.vertices[i], pos, iNearest, minDistSq);
+                }
+            }
+        }
+        return l.toFiner[iNearest - nLevelDummies];
+    }
+
+    /// Update nearest vertex if given level's point is closer
+    static void updateNearest(
+        const LevelTriangulation& cdt,
+        const VertInd iV,
+        const V2d<TCoordType>& pos,
+        VertInd& iNearest,
+        TCoordType& minDistSq)
+    {
+        if(iV < nLevelDummies)
+            return;
+        const TCoordType distSq = distanceSquared(pos, cdt.vertices[iV]);
+        if(distSq < minDistSq)
+        {
+            minDistSq = distSq;
+            iNearest = iV;
+        }
+    }
+
+    /**
+     * Visibility walk from a vertex towards position
+     * @note terminates for any choice of crossed edge in Delaunay
+     * triangulations, so no randomization is needed
+     */
+    static TriInd walk(
+        const LevelTriangulation& cdt,
+        const VertInd start,
+        const V2d<TCoordType>& pos)
+    {
+        TriInd iT = cdt.vertTris[start].front();
+        while(true)
+        {
+            const Triangle& t = cdt.triangles[iT];
+            Index i(0);
+            for(; i < Index(3); ++i)
+            {
+                if(t.neighbors[i] == noNeighbor)
+                    continue;
+                const V2d<TCoordType>& vStart = cdt.vertices[t.vertices[i]];
+                const V2d<TCoordType>& vEnd =
+                    cdt.vertices[t.vertices[ccw(i)]];
+                if(locatePointLine(pos, vStart, vEnd) == PtLineLocation::Right)
+                    break;
+            }
+            if(i == Index(3))
+                return iT;
+            iT = t.neighbors[i];
+        }
+    }
+
+    /// Add a coarser level with only the dummy vertices
+    void addLevel()
+    {
+        m_levels.push_back(Level(&m_hint));
+        const V2d<TCoordType>& min = m_levelsBox.min;
+        const V2d<TCoordType>& max = m_levelsBox.max;
+        std::vector<V2d<TCoordType> > corners;
+        corners.push_back(min);
+        corners.push_back(V2d<TCoordType>::make(max.x, min.y));
+        corners.push_back(max);
+        corners.push_back(V2d<TCoordType>::make(min.x, max.y));
+        m_hint = 0;
+        m_levels.back().cdt.insertVertices(corners);
+    }
+
+    /// Re-build levels with current box and points of given levels
+    void copyLevels(const std::vector<Level>& levels)
+    {
+        m_levels.clear();
+        typedef typename std::vector<Level>::const_iterator Cit;
+        for(Cit it = levels.begin(); it != levels.end(); ++it)
+        {
+            addLevel();
+            Level& l = m_levels.back();
+            const LevelTriangulation& src = it->cdt;
+            for(VertInd iV = nLevelDummies; iV < src.vertices.size(); ++iV)
+            {
+                // walk from the previous point
+                m_hint = iV - 1;
+                const V2d<TCoordType>& pos = src.vertices[iV];
+                l.cdt.insertVertices(
+                    &pos,
+                    &pos + 1,
+                    getX_V2d<TCoordType>,
+                    getY_V2d<TCoordType>);
+            }
+            l.toFiner = it->toFiner;
+        }
+    }
+
+    /// Number of coarse levels a point is inserted to (pseudo-random)
+    static std::size_t randomLevel(const VertInd i)
+    {
+        unsigned int h = static_cast<unsigned int>(i);
+        h = ((h >> 16) ^ h) * 0x45d9f3bu;
+        h = ((h >> 16) ^ h) * 0x45d9f3bu;
+        h = (h >> 16) ^ h;
+        std::size_t level = 0;
+        for(; level < MaxLevels && h % Ratio == 0; h /= Ratio)
+            ++level;
+        return level;
+    }
+
+    static void expandBox(Box2d<TCoordType>& box, const V2d<TCoordType>& p)
+    {
+        box.min.x = std::min(box.min.x, p.x);
+        box.max.x = std::max(box.max.x, p.x);
+        box.min.y = std::min(box.min.y, p.y);
+        box.max.y = std::max(box.max.y, p.y);
+    }
+
+    static bool
+    isStrictlyInside(const Box2d<TCoordType>& box, const V2d<TCoordType>& p)
+    {
+        return p.x > box.min.x && p.x < box.max.x && p.y > box.min.y &&
+               p.y < box.max.y;
+    }
+
+    /// Box grown by half of its larger size on each side
+    static Box2d<TCoordType> inflatedBox(const Box2d<TCoordType>& box)
+    {
+        const TCoordType margin =
+            std::max(box.max.x - box.min.x, box.max.y - box.min.y) /
+            TCoordType(2);
+        Box2d<TCoordType> out = box;
+        out.min.x -= margin;
+        out.min.y -= margin;
+        out.max.x += margin;
+        out.max.y += margin;
+        return out;
+    }
+
+    Box2d<TCoordType> m_box;       // box of all added points
+    Box2d<TCoordType> m_levelsBox; // box of levels' dummy corner vertices
+    VertInd m_firstPoint;
+    VertInd m_hint; // start vertex for insertions into levels
+    std::vector<Level> m_levels; // from the finest to the coarsest
+};
+
+} // namespace CDT
+
+#endif
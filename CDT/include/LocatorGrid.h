@@ -0,0 +1,332 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+/**
+ * @file
+ * Uniform bucket grid for locating near points
+ */
+
+#ifndef CDT_LOCATORGRID_H
+#define CDT_LOCATORGRID_H
+
+#include "CDTUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace CDT
+{
+
+/**
+ * Uniform grid of point buckets for locating near points
+ *
+ * Alternative to @ref LocatorKDTree for near-uniform point densities: cell of
+ * a query point is found in O(1) and the nearest point is searched in rings of
+ * cells spiraling out from it, which also handles empty cells.
+ *
+ * Each cell holds a singly-linked list of points threaded through a
+ * per-point array, so adding a point is O(1) and no per-cell allocations are
+ * made. Grid is rebuilt (re-hashed) when the average number of points per
+ * non-empty cell exceeds @p MaxPointsPerCell, at most once per doubling of
+ * points count. Points outside of grid's box (e.g., super-triangle vertices)
+ * are kept in a short list that is scanned by every query. When the list
+ * gets longer than @p MaxPointsPerCell the box is grown (at least doubled)
+ * to contain them and the grid is re-hashed: this happens at most once per
+ * doubling of the box size. When re-hashing, grid resolution is refined if
+ * most of the cells are empty (e.g., box is inflated by the super-triangle
+ * vertices).
+ *
+ * Grid is not adaptive: strongly clustered points pile up in few cells which
+ * then have to be scanned linearly. Use @ref LocatorKDTree for such inputs.
+ *
+ * @note Queries are const and use no shared scratch memory: concurrent
+ * queries are safe when no points are added at the same time.
+ * @tparam TCoordType type used for storing point coordinate.
+ * @tparam MaxPointsPerCell average number of points per cell that triggers
+ * re-hashing into a finer grid
+ */
+template <typename TCoordType, size_t MaxPointsPerCell = 4>
+class LocatorGrid
+{
+public:
+    /// Default constructor: grid is sized from the added points
+    LocatorGrid()
+        : m_nPoints(0)
+        , m_nPointsRehashed(0)
+        , m_nOccupied(0)
+        , m_nOutside(0)
+        , m_outsideHead(noPoint)
+        , m_nx(0)
+        , m_ny(0)
+    {
+        const TCoordType max = std::numeric_limits<TCoordType>::max();
+        m_min = V2d<TCoordType>::make(max, max);
+        m_max = V2d<TCoordType>::make(-max, -max);
+    }
+    /**
+     * Constructor pre-sizing the grid: grid is not re-hashed before the
+     * expected number of points is reached
+     * @param box bounding box of the points that will be added (e.g.,
+     * calculated with @ref envelopBox)
+     * @param nPointsExpected expected number of points
+     */
+    LocatorGrid(const Box2d<TCoordType>& box, const std::size_t nPointsExpected)
+        : m_nPoints(0)
+        , m_nPointsRehashed((nPointsExpected + 1) / 2)
+        , m_nOccupied(0)
+        , m_nOutside(0)
+        , m_outsideHead(noPoint)
+        , m_nx(0)
+        , m_ny(0)
+        , m_min(box.min)
+        , m_max(box.max)
+        , m_next(nPointsExpected, noPoint)
+    {
+        resize(nPointsExpected);
+    }
+    /// Add point to the grid
+    void addPoint(const VertInd i, const std::vector<V2d<TCoordType> >& points)
+    {
+        const V2d<TCoordType>& pos = points[i];
+        if(i >= m_next.size())
+            m_next.resize(std::max<std::size_t>(i + 1, 2 * m_next.size()));
+        ++m_nPoints;
+        if(pos.x < m_min.x || pos.x > m_max.x || pos.y < m_min.y ||
+           pos.y > m_max.y)
+        {
+            m_next[i] = m_outsideHead;
+            m_outsideHead = i;
+            if(++m_nOutside <= MaxPointsPerCell)
+                return;
+            // too many points outside: grow the box to contain them
+            for(VertInd iV = m_outsideHead; iV != noPoint; iV = m_next[iV])
+                growBox(points[iV]);
+            rehash(points);
+            return;
+        }
+        pushToCell(cellIndex(pos), i);
+        if(m_nPoints > MaxPointsPerCell * m_nOccupied &&
+           m_nPoints >= 2 * m_nPointsRehashed)
+        {
+            rehash(points);
+        }
+    }
+    /// Find nearest point using spiral search over grid cells
+    VertInd nearPoint(
+        const V2d<TCoordType>& pos,
+        const std::vector<V2d<TCoordType> >& points) const
+    {
+        VertInd out = noPoint;
+        TCoordType minDistSq = std::numeric_limits<TCoordType>::max();
+        for(VertInd iV = m_outsideHead; iV != noPoint; iV = m_next[iV])
+        {
+            const TCoordType distSq = distanceSquared(pos, points[iV]);
+            if(distSq < minDistSq)
+            {
+                minDistSq = distSq;
+                out = iV;
+            }
+        }
+        if(m_cellHeads.empty())
+            return out;
+        const std::size_t cx = cellCoord(pos.x, m_min.x, m_cellSize.x, m_nx);
+        const std::size_t cy = cellCoord(pos.y, m_min.y, m_cellSize.y, m_ny);
+        const TCoordType minCellSize = std::min(m_cellSize.x, m_cellSize.y);
+        // distance from query point to grid's box if point is outside
+        const TCoordType toBox = std::max(
+            std::max(m_min.x - pos.x, pos.x - m_max.x),
+            std::max(m_min.y - pos.y, pos.y - m_max.y));
+        const std::size_t maxRing = std::max(m_nx, m_ny);
+        for(std::size_t r = 0; r <= maxRing; ++r)
+        {
+            // points in not yet visited rings (r and further) are at least
+            // this far
+            const TCoordType ringDist = std::max(
+                toBox, r ? TCoordType(r - 1) * minCellSize : TCoordType(0));
+            if(out != noPoint && minDistSq <= ringDist * ringDist)
+                break;
+            visitRing(cx, cy, r, pos, points, out, minDistSq);
+        }
+        return out;
+    }
+
+private:
+    /// Visit cells on a square ring of a given radius around a cell
+    void visitRing(
+        const std::size_t cx,
+        const std::size_t cy,
+        const std::size_t r,
+        const V2d<TCoordType>& pos,
+        const std::vector<V2d<TCoordType> >& points,
+        VertInd& nearest,
+        TCoordType& minDistSq) const
+    {
+        const std::ptrdiff_t x0 = std::ptrdiff_t(cx) - std::ptrdiff_t(r);
+        const std::ptrdiff_t x1 = std::ptrdiff_t(cx) + std::ptrdiff_t(r);
+        const std::ptrdiff_t y0 = std::ptrdiff_t(cy) - std::ptrdiff_t(r);
+        const std::ptrdiff_t y1 = std::ptrdiff_t(cy) + std::ptrdiff_t(r);
+        for(std::ptrdiff_t y = y0; y <= y1; ++y)
+        {
+            if(y < 0 || y >= std::ptrdiff_t(m_ny))
+                continue;
+            // inner rows of the ring only have the two border cells
+            const std::ptrdiff_t step =
+                (y == y0 || y == y1 || r == 0) ? 1 : x1 - x0;
+            for(std::ptrdiff_t x = x0; x <= x1; x += step)
+            {
+                if(x < 0 || x >= std::ptrdiff_t(m_nx))
+                    continue;
+                VertInd iV = m_cellHeads[std::size_t(y) * m_nx + x];
+                for(; iV != noPoint; iV = m_next[iV])
+                {
+                    const TCoordType distSq = distanceSquared(pos, points[iV]);
+                    if(distSq < minDistSq)
+                    {
+                        minDistSq = distSq;
+                        nearest = iV;
+                    }
+                }
+            }
+        }
+    }
+
+    /// Grow grid's box to contain a point; box is at least doubled
+    void growBox(const V2d<TCoordType>& pos)
+    {
+        if(m_min.x > m_max.x) // box was not initialized
+        {
+            m_min = m_max = pos;
+            return;
+        }
+        const TCoordType w = m_max.x - m_min.x;
+        const TCoordType h = m_max.y - m_min.y;
+        if(pos.x < m_min.x)
+            m_min.x = std::min(pos.x, m_min.x - w);
+        if(pos.x > m_max.x)
+            m_max.x = std::max(pos.x, m_max.x + w);
+        if(pos.y < m_min.y)
+            m_min.y = std::min(pos.y, m_min.y - h);
+        if(pos.y > m_max.y)
+            m_max.y = std::max(pos.y, m_max.y + h);
+    }
+
+    /// Re-distribute all points into a grid sized for current points count
+    void rehash(const std::vector<V2d<TCoordType> >& points)
+    {
+        std::vector<VertInd> all;
+        all.reserve(m_nPoints);
+        typedef std::vector<VertInd>::const_iterator Cit;
+        for(Cit it = m_cellHeads.begin(); it != m_cellHeads.end(); ++it)
+            for(VertInd iV = *it; iV != noPoint; iV = m_next[iV])
+                all.push_back(iV);
+        for(VertInd iV = m_outsideHead; iV != noPoint; iV = m_next[iV])
+            all.push_back(iV);
+        m_outsideHead = noPoint;
+        m_nOutside = 0;
+        m_nPointsRehashed = m_nPoints;
+        // twice the capacity: next re-hash when points count doubles
+        std::size_t capacity = 2 * m_nPoints;
+        resize(capacity);
+        distribute(all, points);
+        // refine grid if most cells are empty
+        const std::size_t maxRefinement = 16;
+        const std::size_t nCells = m_cellHeads.size();
+        if(2 * m_nOccupied < nCells)
+        {
+            capacity *= std::min(nCells / m_nOccupied, maxRefinement);
+            resize(capacity);
+            distribute(all, points);
+        }
+    }
+
+    /// Put points to cells
+    void distribute(
+        const std::vector<VertInd>& pointIndices,
+        const std::vector<V2d<TCoordType> >& points)
+    {
+        typedef std::vector<VertInd>::const_iterator Cit;
+        for(Cit it = pointIndices.begin(); it != pointIndices.end(); ++it)
+            pushToCell(cellIndex(points[*it]), *it);
+    }
+
+    /// Set grid resolution so that cells are close to square
+    void resize(const std::size_t nPointsCapacity)
+    {
+        const std::size_t nCells =
+            std::max<std::size_t>(1, nPointsCapacity / MaxPointsPerCell);
+        const TCoordType w = std::max(m_max.x - m_min.x, TCoordType(0));
+        const TCoordType h = std::max(m_max.y - m_min.y, TCoordType(0));
+        if(w > TCoordType(0) && h > TCoordType(0))
+        {
+            const TCoordType nx = std::sqrt(TCoordType(nCells) * w / h);
+            m_nx = std::max<std::size_t>(1, static_cast<std::size_t>(nx));
+            m_ny = std::max<std::size_t>(1, nCells / m_nx);
+        }
+        else // degenerate box: points on a line
+        {
+            m_nx = w > TCoordType(0) ? nCells : 1;
+            m_ny = h > TCoordType(0) ? nCells : 1;
+        }
+        m_cellSize = V2d<TCoordType>::make(
+            w > TCoordType(0) ? w / TCoordType(m_nx) : TCoordType(1),
+            h > TCoordType(0) ? h / TCoordType(m_ny) : TCoordType(1));
+        m_cellHeads.assign(m_nx * m_ny, noPoint);
+        m_nOccupied = 0;
+    }
+
+    /// Cell coordinate of a point coordinate (clamped to grid)
+    static std::size_t cellCoord(
+        const TCoordType c,
+        const TCoordType min,
+        const TCoordType cellSize,
+        const std::size_t n)
+    {
+        const TCoordType i = (c - min) / cellSize;
+        if(!(i > TCoordType(0)))
+            return 0;
+        return std::min(static_cast<std::size_t>(i), n - 1);
+    }
+
+    /// Index of cell containing a point
+    std::size_t cellIndex(const V2d<TCoordType>& pos) const
+    {
+        return cellCoord(pos.y, m_min.y, m_cellSize.y, m_ny) * m_nx +
+               cellCoord(pos.x, m_min.x, m_cellSize.x, m_nx);
+    }
+
+    /// Add point to cell's list
+    void pushToCell(const std::size_t iCell, const VertInd iV)
+    {
+        if(m_cellHeads[iCell] == noPoint)
+            ++m_nOccupied;
+        m_next[iV] = m_cellHeads[iCell];
+        m_cellHeads[iCell] = iV;
+    }
+
+    static const VertInd noPoint;
+
+    std::size_t m_nPoints;
+    std::size_t m_nPointsRehashed; // points count at the last re-hash
+    std::size_t m_nOccupied;       // number of non-empty cells
+    std::size_t m_nOutside;        // number of points outside of the box
+    VertInd m_outsideHead;         // first point outside of the box
+    std::size_t m_nx;
+    std::size_t m_ny;
+    V2d<TCoordType> m_min;
+    V2d<TCoordType> m_max;
+    V2d<TCoordType> m_cellSize;
+    std::vector<VertInd> m_cellHeads; // first point in each cell
+    std::vector<VertInd> m_next;      // next point in the same cell/list
+};
+
+template <typename TCoordType, size_t MaxPointsPerCell>
+const VertInd LocatorGrid<TCoordType, MaxPointsPerCell>::noPoint =
+    std::numeric_limits<VertInd>::max();
+
+} // namespace CDT
+
+#endif
@@ -16,7 +16,16 @@
 namespace CDT
 {
 
-/// KD-tree holding points
+/**
+ * KD-tree holding points
+ *
+ * Supports exact and approximate (faster) nearest point search.
+ *
+ * Thread-safety: @ref nearPoint uses a stack stored in the locator and is not
+ * re-entrant. Once all points are added the locator can be queried from
+ * multiple threads concurrently using the overload taking a caller-provided
+ * @ref QueryStack (one per thread).
+ */
 template <
     typename TCoordType,
     size_t NumVerticesInLeaf = 32,
@@ -24,27 +33,81 @@ template <
     size_t StackDepthIncrement = 32>
 class LocatorKDTree
 {
+    typedef KDTree::KDTree<
+        TCoordType,
+        NumVerticesInLeaf,
+        InitialStackDepth,
+        StackDepthIncrement>
+        KDTreeType;
+
 public:
+    /// Traversal stack for re-entrant queries
+    typedef typename KDTreeType::NearestTasksStack QueryStack;
+
+    /// Default constructor: exact nearest point search
+    LocatorKDTree()
+        : m_maxVisitedLeaves(0)
+    {}
+    /**
+     * Constructor for approximate nearest point search
+     *
+     * Search for a near point stops after visiting given number of non-empty
+     * kd-tree leaves. Found point is not necessarily the nearest but is
+     * typically close enough to be a good start for a triangle walk.
+     * @param maxVisitedLeaves maximum number of non-empty leaves visited in
+     * a search; 0 means no limit (exact search)
+     */
+    explicit LocatorKDTree(const std::size_t maxVisitedLeaves)
+        : m_maxVisitedLeaves(maxVisitedLeaves)
+    {}
+
     /// Add point to R-tree
     void addPoint(const VertInd i, const std::vector<V2d<TCoordType> >& points)
     {
         m_kdTree.insert(i, points);
     }
+    /// Remove point from R-tree
+    /// @note point must be at the same position as when it was added
+    /// @returns true if point was found and removed
+    bool
+    removePoint(const VertInd i, const std::vector<V2d<TCoordType> >& points)
+    {
+        return m_kdTree.remove(i, points);
+    }
+    /// Update position of a point that was moved
+    /// @returns true if point was found at the old position and relocated
+    bool relocatePoint(
+        const VertInd i,
+        const V2d<TCoordType>& oldPos,
+        const std::vector<V2d<TCoordType> >& points)
+    {
+        return m_kdTree.relocate(i, oldPos, points);
+    }
+    /// Rebuild R-tree to be balanced
+    void rebalance(const std::vector<V2d<TCoordType> >& points)
+    {
+        m_kdTree.rebalance(points);
+    }
     /// Find nearest point using R-tree
     VertInd nearPoint(
         const V2d<TCoordType>& pos,
         const std::vector<V2d<TCoordType> >& points) const
     {
-        return m_kdTree.nearest(pos, points).second;
+        return m_kdTree.nearest(pos, points, m_maxVisitedLeaves).second;
+    }
+    /// Find nearest point using R-tree: re-entrant version
+    /// @note safe to call concurrently if each thread has its own stack
+    VertInd nearPoint(
+        const V2d<TCoordType>& pos,
+        const std::vector<V2d<TCoordType> >& points,
+        QueryStack& stack) const
+    {
+        return m_kdTree.nearest(pos, points, stack, m_maxVisitedLeaves).second;
     }
 
 private:
-    KDTree::KDTree<
-        TCoordType,
-        NumVerticesInLeaf,
-        InitialStackDepth,
-        StackDepthIncrement>
-        m_kdTree;
+    KDTreeType m_kdTree;
+    std::size_t m_maxVisitedLeaves;
 };
 
 } // namespace CDT
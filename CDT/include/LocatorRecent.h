@@ -0,0 +1,91 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+/**
+ * @file
+ * Index-free locator returning recently added points
+ */
+
+#ifndef CDT_LOCATORRECENT_H
+#define CDT_LOCATORRECENT_H
+
+#include "CDTUtils.h"
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace CDT
+{
+
+/**
+ * Locator without a spatial index: near point is picked among the most
+ * recently added points
+ *
+ * Keeps a ring of the last @p NumRecent added points and returns the one
+ * closest to the query position as the start of a triangle walk. Adding a
+ * point is O(1), querying is O(NumRecent), there is no per-point memory.
+ *
+ * This is a win only when consecutive points are close to each other, so
+ * that the walk from a recent point is short:
+ *  - spatially sorted input (e.g., Hilbert or Morton curve order) inserted
+ *    with @ref VertexInsertionOrder::AsProvided;
+ *  - rasters and scanlines: only the jump to the start of the next line
+ *    needs a long walk.
+ *
+ * A small ring (a few points) helps when the order occasionally jumps back.
+ * Large rings cost more to scan than the walk they save.
+ *
+ * For randomized or otherwise incoherent insertion orders the walk length is
+ * proportional to sqrt(N) per point, use @ref LocatorKDTree instead.
+ *
+ * @note Queries are const and do not modify the locator.
+ * @tparam TCoordType type used for storing point coordinate.
+ * @tparam NumRecent number of most recently added points that are considered
+ */
+template <typename TCoordType, size_t NumRecent = 1>
+class LocatorRecent
+{
+public:
+    /// Constructor
+    LocatorRecent()
+        : m_nAdded(0)
+    {}
+    /// Remember point as the most recent one
+    void addPoint(const VertInd i, const std::vector<V2d<TCoordType> >&)
+    {
+        m_recent[m_nAdded % NumRecent] = i;
+        ++m_nAdded;
+    }
+    /// Find the recent point closest to the given position
+    VertInd nearPoint(
+        const V2d<TCoordType>& pos,
+        const std::vector<V2d<TCoordType> >& points) const
+    {
+        if(m_nAdded == 0)
+            return std::numeric_limits<VertInd>::max();
+        const std::size_t n = m_nAdded < NumRecent ? m_nAdded : NumRecent;
+        VertInd out = m_recent[(m_nAdded - 1) % NumRecent];
+        TCoordType minDistSq = distanceSquared(pos, points[out]);
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const VertInd iV = m_recent[i];
+            const TCoordType distSq = distanceSquared(pos, points[iV]);
+            if(distSq < minDistSq)
+            {
+                minDistSq = distSq;
+                out = iV;
+            }
+        }
+        return out;
+    }
+
+private:
+    std::size_t m_nAdded;
+    VertInd m_recent[NumRecent]; // ring buffer of recently added points
+};
+
+} // namespace CDT
+
+#endif
@@ -16,6 +16,7 @@
 #include "CDT.hpp"
 #include "CDTUtils.hpp"
 #include "InitializeWithGrid.h"
+#include "LocatorDelaunayHierarchy.h"
 #include "VerifyTopology.h"
 
 namespace CDT
@@ -23,6 +24,9 @@ namespace CDT
 
 template class Triangulation<float>;
 template class Triangulation<double>;
+// levels of Delaunay hierarchy locator
+template class Triangulation<float, detail::LocatorHint<float> >;
+template class Triangulation<double, detail::LocatorHint<double> >;
 template struct V2d<float>;
 template struct V2d<double>;
 template struct Box2d<float>;
@@ -41,8 +45,21 @@ template DuplicatesInfo RemoveDuplicatesAndRemapEdges<double>(
     std::vector<V2d<double> >&,
     std::vector<Edge>&);
 
+template DuplicatesInfo RemoveNearDuplicatesAndRemapEdges<float>(
+    std::vector<V2d<float> >&,
+    std::vector<Edge>&,
+    float);
+template DuplicatesInfo RemoveNearDuplicatesAndRemapEdges<double>(
+    std::vector<V2d<double> >&,
+    std::vector<Edge>&,
+    double);
+
 template bool verifyTopology<float>(const CDT::Triangulation<float>&);
 template bool verifyTopology<double>(const CDT::Triangulation<double>&);
+template TriangulationDiagnostics
+verifyTriangulation<float>(const CDT::Triangulation<float>&);
+template TriangulationDiagnostics
+verifyTriangulation<double>(const CDT::Triangulation<double>&);
 
 template void initializeWithRegularGrid<float>(
     float,